@@ -0,0 +1,44 @@
+#ifndef CAIG_H
+#define CAIG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// And-Inverter Graph Class: 2-input AND nodes joined by possibly inverted edges.
+// A literal is node * 2 + inverted; node 0 is constant false, inputs come next
+// and AND nodes follow in topological order.
+class CAig {
+public:
+    static constexpr uint32_t LITERAL_FALSE = 0;
+    static constexpr uint32_t LITERAL_TRUE = 1;
+
+    static uint32_t Not(uint32_t literal) { return literal ^ 1u; }
+
+    uint32_t AddInput();
+    uint32_t AddAnd(uint32_t literal0, uint32_t literal1);
+    uint32_t AddOr(uint32_t literal0, uint32_t literal1);
+    uint32_t AddXor(uint32_t literal0, uint32_t literal1);
+
+    size_t GetInputCount() const;
+    size_t GetAndCount() const;
+    size_t GetNodeCount() const;
+    size_t GetMemoryBytes() const;
+
+    void Simulate(std::vector<uint64_t>& nodeValues) const;
+    static uint64_t GetLiteralValue(const std::vector<uint64_t>& nodeValues, uint32_t literal);
+
+private:
+    // AND node stored as its two fan-in literals
+    struct SAndNode {
+        uint32_t fanin0;
+        uint32_t fanin1;
+    };
+
+    uint32_t inputCount = 0;
+    std::vector<SAndNode> ands;
+    std::unordered_map<uint64_t, uint32_t> structuralHash;  // Fan-in pair to existing AND literal
+};
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef CASYNC_WRITER_H
+#define CASYNC_WRITER_H
+
+#include <cstddef>
+#include <streambuf>
+#include <vector>
+
+// Async Writer Class, a stream buffer that writes to a file descriptor through
+// Linux io_uring. Output fills one of two large buffers while the other is
+// being written by the kernel, so formatting only waits when both are full.
+// At most one write is in flight, which keeps the output in order. Without
+// io_uring it falls back to plain write calls from the same buffers.
+class CAsyncWriter : public std::streambuf {
+public:
+    explicit CAsyncWriter(int fd, bool useRing = true);
+    ~CAsyncWriter() override;
+    CAsyncWriter(const CAsyncWriter&) = delete;
+    CAsyncWriter& operator=(const CAsyncWriter&) = delete;
+    bool IsAsync() const { return ringFd >= 0; }
+    bool Close();
+
+protected:
+    int overflow(int c) override;
+    std::streamsize xsputn(const char* data, std::streamsize size) override;
+    int sync() override;
+
+private:
+    bool SetupRing();
+    void CloseRing();
+    void Submit();
+    void StartWrite(const char* data, size_t size);
+    void QueueWrite();
+    bool ReapWrite(int& result);
+    void WaitWrite();
+    void FallBack();
+    void WriteDirect(const char* data, size_t size);
+
+    int fd;
+    bool failed = false;
+    std::vector<char> buffers[2];
+    int active = 0;                     // Buffer being filled; the other may be in flight
+    const char* pendingData = nullptr;  // Part of the in-flight buffer not yet written
+    size_t pendingSize = 0;
+
+    int ringFd = -1;                    // io_uring instance, -1 when writing directly
+    void* ringMemory = nullptr;         // Submission ring, and the completion ring when they share a mapping
+    size_t ringBytes = 0;
+    void* completionMemory = nullptr;   // Completion ring when it has its own mapping
+    size_t completionBytes = 0;
+    void* entryMemory = nullptr;        // Submission queue entries
+    size_t entryBytes = 0;
+    unsigned* submitTail = nullptr;
+    unsigned* submitMask = nullptr;
+    unsigned* submitArray = nullptr;
+    unsigned* completeHead = nullptr;
+    unsigned* completeTail = nullptr;
+    unsigned* completeMask = nullptr;
+    void* completionEntries = nullptr;
+};
+
+#endif
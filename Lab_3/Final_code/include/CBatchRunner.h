@@ -0,0 +1,23 @@
+#ifndef CBATCHRUNNER_H
+#define CBATCHRUNNER_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Batch Runner Class that simulates many independent circuit files on a pool
+// of worker threads, one Circuit per file. Each file's output either goes to
+// its own file or is merged in list order.
+class CBatchRunner {
+public:
+    explicit CBatchRunner(const std::vector<std::string>& circuitPaths);
+    static bool ReadList(const std::string& listPath, std::vector<std::string>& circuitPaths);
+    int Run(int jobs, const std::string& outputDirectory, std::ostream& merged = std::cout);
+
+private:
+    bool RunTask(size_t task, const std::string& outputDirectory, std::string& output);
+
+    std::vector<std::string> circuitPaths;
+};
+
+#endif
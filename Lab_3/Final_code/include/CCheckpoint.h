@@ -0,0 +1,35 @@
+#ifndef CCHECKPOINT_H
+#define CCHECKPOINT_H
+
+#include <cstdint>
+#include <string>
+#include "Circuit.h"
+
+// Checkpoint Class that saves the logic levels of every gate as a compact
+// binary image and restores them by memory-mapping the image. The image holds
+// a hash of the netlist and is only restored into an identical netlist.
+class CCheckpoint {
+public:
+    CCheckpoint(Circuit& circuit);
+    bool Save(const std::string& path) const;
+    bool Restore(const std::string& path);
+    uint64_t NetlistHash() const;
+
+private:
+    // Fixed-size start of an image, followed by one byte per stored level
+    struct SHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t gateCount;
+        uint64_t netlistHash;
+        uint64_t levelCount;
+        uint8_t lazyEvaluation;
+        uint8_t padding[7];
+    };
+
+    uint64_t LevelCount() const;
+
+    Circuit& circuit;
+};
+
+#endif
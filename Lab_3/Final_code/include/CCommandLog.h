@@ -0,0 +1,40 @@
+#ifndef CCOMMAND_LOG_H
+#define CCOMMAND_LOG_H
+
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include "CFileReader.h"
+
+// Command log Class that records parsed commands into a compact binary log and
+// replays them without any text parsing. Gate handles are stored as they were
+// resolved, names go into a string table written once, and each command packs
+// its type and logic level into one byte followed by variable-length integers.
+class CCommandLog {
+public:
+    ~CCommandLog();
+    bool Create(const std::string& path);
+    void Append(const SCommand& command);
+    bool Close();
+    bool Load(const std::string& path);
+    bool Next(SCommand& command);
+
+private:
+    void PutVarint(uint64_t value);
+    uint32_t PutString(const std::string* text);
+    bool GetVarint(uint64_t& value);
+    bool GetString(const std::string*& text);
+
+    std::string logPath;
+    std::FILE* file = nullptr;                          // Log being recorded
+    bool failed = false;
+    std::string pending;                                // Encoded bytes not yet written
+    std::unordered_map<std::string, uint32_t> stringIds;  // Recorded strings, ids from 1
+    std::string data;                                   // Whole log being replayed
+    size_t position = 0;
+    std::deque<std::string> strings;                    // Replayed strings; commands point into them
+};
+
+#endif
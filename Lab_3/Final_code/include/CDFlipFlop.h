@@ -0,0 +1,22 @@
+#ifndef CDFLIPFLOP_H
+#define CDFLIPFLOP_H
+
+#include "CLogicGates.h"
+
+// D Flip-Flop Class (input 0 is D, the output is Q)
+class CDFlipFlop : public CLogicGates {
+public:
+    CDFlipFlop();
+    void DriveInput(int inputIndex, eLogicLevel level) override;
+    eLogicLevel GetOutputState() const override;
+    CLogicGates* Clone() const override;
+    size_t GetMemoryBytes() const override;
+    bool IsSequential() const override;
+
+    void Latch();
+
+protected:
+    void ComputeOutput() override;
+};
+
+#endif
@@ -1,16 +1,80 @@
 #ifndef CFILE_READER_H
 #define CFILE_READER_H
 
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include "Circuit.h"
+#include "CPackedState.h"
 
-// File reader Class that reads the text file from the terminal
+class CCommandLog;
+
+enum class eCommand {
+    COMMAND_COMPONENT, COMMAND_REGISTER, COMMAND_CONNECT, COMMAND_TIE, COMMAND_OBSERVE,
+    COMMAND_OPTIMIZE, COMMAND_AIG, COMMAND_STIMULUS, COMMAND_ACTIVITY, COMMAND_LAZY, COMMAND_PRUNE, COMMAND_SAVE, COMMAND_RESTORE, COMMAND_CLOCK,
+    COMMAND_INPUT, COMMAND_OUTPUT, COMMAND_COMPARATOR_OUTPUT, COMMAND_RECORD, COMMAND_MEMORY,
+    COMMAND_SNAPSHOT, COMMAND_COMPARE, COMMAND_DIFF, COMMAND_END
+};
+
+// A parsed command; gate names are resolved to gate indices while parsing
+struct SCommand {
+    eCommand type = eCommand::COMMAND_END;
+    int gate = -1;                          // Gate index, -1 if the name is not declared
+    int value = 0;                          // Input index, cycle count, register width or input count
+    int level = 0;
+    const std::string* name = nullptr;      // Gate name, interned by the reader
+    const std::string* argument = nullptr;  // Gate type, target gate, output type, path or setting
+};
+
+// The outcome of one command, ready to be formatted
+struct SResult {
+    SCommand command;
+    bool ok = false;
+    int value = 0;                          // Logic level or removed gate count
+    std::string text;
+};
+
+// File reader Class that reads the text file from the terminal. Each command is
+// parsed, executed on the circuit and formatted, either in lockstep on one
+// thread or as a three-thread pipeline.
 class CFileReader {
 public:
-    CFileReader(Circuit& circuit);
+    CFileReader(Circuit& circuit, std::istream& input = std::cin, std::ostream& output = std::cout, 
+                std::ostream& errors = std::cerr);
     void ProcessInput();
+    void ProcessInputPipelined();
+    void RecordTo(CCommandLog* log) { recordLog = log; }
+    void ReplayFrom(CCommandLog* log) { replayLog = log; }
 
 private:
+    bool NextCommand(SCommand& command);
+    bool ParseCommand(SCommand& command);
+    void ExecuteCommand(const SCommand& command, SResult& result);
+    void FormatResult(const SResult& result);
+
+    const std::string* Intern(const std::string& text);
+    int ResolveGate(const std::string& gateName) const;
+    void DeclareGate(const std::string& gateType, const std::string& gateName, int inputCount);
+    void ReloadGateTable();
+    const CPackedState* FindSnapshot(const std::string& snapshotName, CPackedState& current);
+    void CompareSnapshots(const SCommand& command, SResult& result);
+    void SampleRecord(SResult& result);
+    void FlushRecords();
+
     Circuit& circuit;
+    std::istream& input;
+    std::ostream& output;
+    std::ostream& errors;                            // Error messages of the reader and the circuit
+    std::unordered_set<std::string> strings;         // Interned names referenced by commands
+    std::unordered_map<std::string, int> gateIds;    // Mirrors the gate indices the circuit assigns
+    int gateCount = 0;
+    std::unordered_map<std::string, CPackedState> snapshots;  // Named whole-circuit states
+    std::vector<int> recordGates;                    // Observed gate indices sampled by record
+    size_t headerOutputs = 0;                        // Observed gates named by the last record header
+    std::string records;                             // Formatted records not yet written to output
+    CCommandLog* recordLog = nullptr;                // Receives every parsed command
+    CCommandLog* replayLog = nullptr;                // Replaces the text input when set
 };
 
 #endif 
@@ -0,0 +1,49 @@
+#ifndef CGATEREGISTRY_H
+#define CGATEREGISTRY_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "CLogicGates.h"
+
+// Creates a gate of one kind with the given number of inputs
+typedef CLogicGates* (*GateFactory)(int inputCount);
+// Computes the output of a combinational gate from its input levels
+typedef eLogicLevel (*GateKernel)(const eLogicLevel* inputs, int inputCount);
+// Lowers a kernel gate into the AND-inverter graph, returning its output literal
+typedef uint32_t (*GateLowering)(CAig& aig, const std::vector<uint32_t>& inputLiterals);
+
+// One registered gate kind. It is built either by its own gate class through
+// factory, or as a CKernelGate running kernel when factory is null.
+struct SGateType {
+    std::string name;
+    GateFactory factory;
+    GateKernel kernel;
+    GateLowering lowering;
+    int defaultInputs;  // Inputs used when the netlist gives no count
+    int minInputs;
+    int maxInputs;
+};
+
+// Registry Class that maps gate type names to dense type ids once, so building
+// a gate is one hash lookup and an indexed call rather than a chain of compares
+class CGateRegistry {
+public:
+    static CGateRegistry& Instance();
+
+    int Register(const SGateType& type);
+    int FindType(const std::string& name) const;
+    bool AcceptsInputCount(int typeId, int inputCount) const;
+    CLogicGates* Create(int typeId, int inputCount) const;
+    const std::string& GetName(int typeId) const;
+    int GetTypeCount() const;
+
+private:
+    CGateRegistry();
+
+    std::unordered_map<std::string, int> typeIds;  // Type name to index into types
+    std::vector<SGateType> types;
+};
+
+#endif
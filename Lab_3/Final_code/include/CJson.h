@@ -0,0 +1,13 @@
+#ifndef CJSON_H
+#define CJSON_H
+
+#include <ostream>
+#include <string>
+
+// JSON Class with the helpers shared by the statistics report and the trace writer
+class CJson {
+public:
+    static void WriteString(std::ostream& out, const std::string& text);
+};
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef CKERNELGATE_H
+#define CKERNELGATE_H
+
+#include "CLogicGates.h"
+#include "CGateRegistry.h"
+
+// KernelGate Class for combinational gate kinds that the registry describes
+// by an evaluation kernel and an AIG lowering instead of their own class
+class CKernelGate : public CLogicGates {
+public:
+    CKernelGate(GateKernel kernel, GateLowering lowering, int inputCount);
+    void DriveInput(int inputIndex, eLogicLevel level) override;
+    eLogicLevel GetOutputState() const override;
+    CLogicGates* Clone() const override;
+    size_t GetMemoryBytes() const override;
+    void LowerToAig(CAig& aig, const std::vector<uint32_t>& inputLiterals,
+                    std::vector<uint32_t>& outputLiterals) const override;
+
+protected:
+    void ComputeOutput() override;
+
+private:
+    GateKernel kernel;
+    GateLowering lowering;
+};
+
+#endif
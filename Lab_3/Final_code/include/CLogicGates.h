@@ -1,21 +1,54 @@
 #ifndef CLOGICGATES_H
 #define CLOGICGATES_H
 
+#include <cstdint>
+#include <cstddef>
 #include <vector>
 
-enum class eLogicLevel { LOGIC_UNDEFINED = -1, LOGIC_LOW = 0, LOGIC_HIGH = 1 };
+class CAig;
+
+static const int INLINE_GATE_INPUTS = 4;  // Inputs stored inside the gate; wider gates use one heap block
+static const int MAX_GATE_INPUTS = 65535;
+
+enum class eLogicLevel : int8_t { LOGIC_UNDEFINED = -1, LOGIC_LOW = 0, LOGIC_HIGH = 1 };
 
 // Parent Class for all logic gates
 class CLogicGates {
 public:
-    virtual ~CLogicGates() = default;
+    CLogicGates() = default;
+    CLogicGates(const CLogicGates& other);
+    CLogicGates& operator=(const CLogicGates&) = delete;
+    virtual ~CLogicGates();
     virtual void DriveInput(int inputIndex, eLogicLevel level) = 0;
     virtual eLogicLevel GetOutputState() const = 0;
+    virtual CLogicGates* Clone() const = 0;
+    virtual size_t GetMemoryBytes() const = 0;
+    virtual bool IsSequential() const { return false; }
+    virtual void LowerToAig(CAig& aig, const std::vector<uint32_t>& inputLiterals,
+                            std::vector<uint32_t>& outputLiterals) const {}  // Sequential gates are lowered by the circuit
+    void Drive(int inputIndex, eLogicLevel level) { DriveInput(inputIndex, level); evaluated = true; }
+    void SetInput(int inputIndex, eLogicLevel level) { inputs[inputIndex] = level; evaluated = false; }  // Stores without evaluating
+    void Evaluate() { ComputeOutput(); evaluated = true; }
+    bool Holds(int inputIndex, eLogicLevel level) const { return evaluated && inputs[inputIndex] == level; }  // Driving it again changes nothing
+    eLogicLevel GetInput(int inputIndex) const { return inputs[inputIndex]; }
+    int GetInputCount() const { return inputCount; }
+    virtual int GetStateCount() const { return 1; }  // Output levels held besides the inputs
+    virtual eLogicLevel GetState(int stateIndex) const { return outputValue; }
+    virtual void SetState(int stateIndex, eLogicLevel level) { outputValue = level; }
 
 protected:
     virtual void ComputeOutput() = 0;
-    std::vector<eLogicLevel> inputs;
+    void SetInputCount(int count);
+    size_t GetInputHeapBytes() const { return (inputs != inlineInputs) ? inputCount : 0; }
+
+    eLogicLevel* inputs = inlineInputs;     // Contiguous input levels, inline or on the heap
+    uint16_t inputCount = 0;
+    eLogicLevel inlineInputs[INLINE_GATE_INPUTS];
     eLogicLevel outputValue = eLogicLevel::LOGIC_UNDEFINED;
+    bool evaluated = false;                 // The output was computed from the present inputs
 };
 
+// Vtable pointer, input pointer, then the count, inline inputs, output and flag packed in one word
+static_assert(sizeof(void*) != 8 || sizeof(CLogicGates) == 24, "CLogicGates must stay three words on 64-bit targets");
+
 #endif 
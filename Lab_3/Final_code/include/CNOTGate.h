@@ -9,6 +9,10 @@ public:
     CNotGate();
     void DriveInput(int inputIndex, eLogicLevel level) override;
     eLogicLevel GetOutputState() const override;
+    CLogicGates* Clone() const override;
+    size_t GetMemoryBytes() const override;
+    void LowerToAig(CAig& aig, const std::vector<uint32_t>& inputLiterals,
+                    std::vector<uint32_t>& outputLiterals) const override;
 
 protected:
     void ComputeOutput() override;
@@ -0,0 +1,39 @@
+#ifndef CNETLISTOPTIMIZER_H
+#define CNETLISTOPTIMIZER_H
+
+#include <string>
+#include <vector>
+#include "Circuit.h"
+
+// Netlist Optimizer Class that simplifies a circuit before it is simulated.
+// Results are preserved for defined (0/1) levels. Gates with an unconnected,
+// untied input may still be driven by stimulus and are never bypassed.
+class CNetlistOptimizer {
+public:
+    CNetlistOptimizer(Circuit& circuit);
+    int Run();
+
+private:
+    bool IsSimpleGate(int gateId) const;
+    bool IsFullyConnected(int gateId) const;
+    eLogicLevel ConstantOutput(int gateId) const;
+    std::string StructuralKey(int gateId) const;
+
+    bool PropagateConstants();
+    bool BypassBuffers();
+    bool CollapseDoubleInversions();
+    bool MergeDuplicates();
+    bool RemoveDeadGates();
+
+    void TieFanout(int gateId, eLogicLevel level);
+    void Redirect(int gateId, int sourceId);
+    void DriveConnection(int targetId, int inputIndex, eLogicLevel level);
+    int Compact();
+
+    Circuit& circuit;
+    std::vector<std::vector<int>> fanins;  // Source gate per input, -1 if not driven by a gate
+    std::vector<bool> removed;
+    std::vector<bool> observed;
+};
+
+#endif
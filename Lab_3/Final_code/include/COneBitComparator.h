@@ -9,6 +9,14 @@ public:
     COneBitComparator();
     void DriveInput(int inputIndex, eLogicLevel level) override;
     eLogicLevel GetOutputState() const override;
+    CLogicGates* Clone() const override;
+    size_t GetMemoryBytes() const override;
+    void LowerToAig(CAig& aig, const std::vector<uint32_t>& inputLiterals,
+                    std::vector<uint32_t>& outputLiterals) const override;
+
+    int GetStateCount() const override;
+    eLogicLevel GetState(int stateIndex) const override;
+    void SetState(int stateIndex, eLogicLevel level) override;
 
     eLogicLevel GetGreaterOutput() const;
     eLogicLevel GetEqualOutput() const;
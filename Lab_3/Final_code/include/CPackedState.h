@@ -0,0 +1,42 @@
+#ifndef CPACKEDSTATE_H
+#define CPACKEDSTATE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "CLogicGates.h"
+
+class Circuit;
+
+// Packed State Class holding a snapshot of every net level in 2 bits, 32 nets
+// per 64-bit word (0 low, 1 high, 2 undefined). Nets are the held outputs of the
+// gates in gate order. The simulation still evaluates the gate objects; a snapshot
+// is a copy taken from them, so comparing or diffing whole-circuit states streams
+// through a few contiguous words instead of visiting every gate object.
+class CPackedState {
+public:
+    static const int NETS_PER_WORD = 32;
+
+    void Capture(const Circuit& circuit);
+    size_t GetNetCount() const;
+    size_t GetMemoryBytes() const;
+
+    eLogicLevel Get(size_t net) const {
+        uint64_t code = (words[net / NETS_PER_WORD] >> (2 * (net % NETS_PER_WORD))) & 3;
+        return (code == 2) ? eLogicLevel::LOGIC_UNDEFINED : static_cast<eLogicLevel>(code);
+    }
+
+    bool Equals(const CPackedState& other) const;
+    size_t CountDifferences(const CPackedState& other) const;
+    void Diff(const CPackedState& other, std::vector<size_t>& nets) const;
+
+private:
+    static uint64_t Encode(eLogicLevel level) {
+        return (level == eLogicLevel::LOGIC_UNDEFINED) ? 2 : static_cast<uint64_t>(level);
+    }
+
+    std::vector<uint64_t> words;
+    size_t netCount = 0;
+};
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef CPARTITIONEDSIM_H
+#define CPARTITIONEDSIM_H
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "CSimConnection.h"
+
+// Partitioned Simulation Class that splits a netlist with CPartitioner and
+// simulates every part in its own forked worker process. The coordinator only
+// keeps the gate table; each worker builds a Circuit for its part. After every
+// step workers report the cut nets whose level changed, and the coordinator
+// drives those levels into the other parts until no cut net changes.
+//
+// Supported commands: component, connect, tie, observe, input, clock, output,
+// comparator_output, record and end. The netlist is partitioned when the first
+// simulation command arrives, so the netlist has to come before the stimulus.
+class CPartitionedSim {
+public:
+    explicit CPartitionedSim(int partCount);
+    ~CPartitionedSim();
+    bool Run(std::istream& input, std::ostream& output);
+    size_t GetCutNetCount() const;
+
+private:
+    // A gate of the whole netlist and where it lives
+    struct SNetGate {
+        std::string name;
+        std::string type;
+        int inputCount;     // Input count given by the netlist, 0 for the default
+        int width;          // Inputs the gate actually has
+        bool comparator;
+        int part = 0;
+        int localId = 0;
+    };
+
+    // A connection from one gate output to a gate input
+    struct SEdge {
+        int source;
+        int target;
+        int inputIndex;
+    };
+
+    // A gate input tied to a constant level
+    struct STie {
+        int gate;
+        int inputIndex;
+        int level;
+    };
+
+    // A gate input in another part fed by a cut net
+    struct SRemoteInput {
+        int part;
+        int localId;
+        int inputIndex;
+    };
+
+    bool ReadNetlistCommand(const std::string& request, std::istream& input);
+    void DeclareGate(const std::string& gateType, const std::string& gateName, int inputCount);
+    bool Partition();
+    void RunWorker(int part, int fd, const std::string& netlist, const std::vector<int>& cutGates);
+    void Exchange(const char* request, std::vector<bool>& pending);
+    void DriveCutNet(int part, int cut, std::vector<bool>& driven);
+    void RedriveCutNets();
+    void Settle();
+    void Stop();
+    int FindGate(const std::string& gateName) const;
+    int QueryLevel(int gate, const std::string& outputType);
+    void WriteRecord(std::ostream& output);
+
+    int partCount;
+    std::vector<SNetGate> gates;
+    std::unordered_map<std::string, int> gateIds;
+    std::vector<SEdge> edges;
+    std::vector<STie> ties;
+    std::vector<std::string> observed;
+    size_t headerOutputs = 0;                    // Observed gates named by the last record header
+
+    bool partitioned = false;
+    size_t cutNetCount = 0;
+    std::vector<std::unique_ptr<CSimConnection>> workers;
+    std::vector<int> workerIds;                  // Process id of each worker
+    std::vector<std::vector<std::vector<SRemoteInput>>> cutFanouts;  // Per part and cut net
+    std::vector<std::vector<int>> cutLevels;     // Last reported level per part and cut net
+    std::vector<bool> pending;                   // Parts that received drives since they last settled
+};
+
+#endif
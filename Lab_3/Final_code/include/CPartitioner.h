@@ -0,0 +1,25 @@
+#ifndef CPARTITIONER_H
+#define CPARTITIONER_H
+
+#include <cstddef>
+#include <vector>
+
+// Partitioner Class that splits a netlist graph into balanced parts with few
+// cut nets. Parts are seeded from a breadth-first order, so connected gates
+// start together, and then refined by moving single gates to the part holding
+// most of their neighbours while the move lowers the cut and keeps the balance.
+class CPartitioner {
+public:
+    explicit CPartitioner(int gateCount);
+    void AddEdge(int source, int target);
+    std::vector<int> Run(int partCount) const;
+    size_t CountCutNets(const std::vector<int>& parts) const;
+
+private:
+    std::vector<int> BreadthFirstOrder() const;
+
+    std::vector<std::vector<int>> fanouts;     // Driven gates of each gate
+    std::vector<std::vector<int>> neighbours;  // Gates sharing an edge, in either direction
+};
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef CSIMCLIENT_H
+#define CSIMCLIENT_H
+
+#include <string>
+#include "CSimConnection.h"
+
+// The answer to one request sent to a simulation server
+struct SSimReply {
+    bool ok = false;
+    std::string output;     // What the simulator printed
+    std::string errors;     // Error messages produced while running the request
+};
+
+// Simulation Client Class that talks to a resident CSimServer. A connection
+// can carry any number of requests.
+class CSimClient {
+public:
+    bool Connect(const std::string& socketPath);
+    bool Load(const std::string& circuitName, const std::string& netlist, SSimReply& reply);
+    bool Run(const std::string& circuitName, const std::string& commands, SSimReply& reply);
+    bool Drop(const std::string& circuitName, SSimReply& reply);
+    bool Shutdown();
+
+private:
+    bool Request(const std::string& header, const std::string& body, SSimReply& reply);
+
+    CSimConnection connection;
+};
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef CSIMCONNECTION_H
+#define CSIMCONNECTION_H
+
+#include <string>
+
+// Buffered stream over a connected Unix domain socket. Reads come from an
+// internal buffer; writes are collected until Flush.
+class CSimConnection {
+public:
+    explicit CSimConnection(int fd = -1);
+    CSimConnection(const CSimConnection&) = delete;
+    CSimConnection& operator=(const CSimConnection&) = delete;
+    ~CSimConnection();
+
+    static int Listen(const std::string& socketPath);
+    static int Connect(const std::string& socketPath);
+
+    void Open(int fd);
+    bool IsOpen() const;
+    void Close();
+    bool ReadLine(std::string& line);
+    bool ReadBytes(size_t count, std::string& data);
+    void Write(const std::string& data);
+    bool Flush();
+
+private:
+    bool Fill();
+
+    int fd;
+    std::string readBuffer;
+    size_t readPosition = 0;    // First unread byte of readBuffer
+    std::string writeBuffer;
+};
+
+#endif
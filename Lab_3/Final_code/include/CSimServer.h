@@ -0,0 +1,48 @@
+#ifndef CSIMSERVER_H
+#define CSIMSERVER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include "Circuit.h"
+#include "CSimConnection.h"
+
+// Simulation Server Class that stays resident on a Unix domain socket and keeps
+// built circuits in memory between requests. Every client is served on its own
+// thread, so a slow or idle client never holds up the others. Requests are a
+// header line and a body of the given size:
+//   LOAD <name> <bytes>   builds a circuit from netlist commands and caches it
+//   RUN <name> <bytes>    runs commands on a fresh copy of a cached circuit
+//   DROP <name>           forgets a cached circuit
+//   SHUTDOWN              stops the server once running requests are answered
+// Every request is answered with "OK|ERROR <outputBytes> <errorBytes>" followed
+// by the simulator output and the error messages.
+class CSimServer {
+public:
+    bool Serve(const std::string& socketPath);
+
+private:
+    void ServeClient(int clientFd);
+    bool HandleConnection(CSimConnection& connection);
+    void Stop();
+    bool Load(const std::string& circuitName, const std::string& netlist, std::string& output, std::string& errors);
+    bool Run(const std::string& circuitName, const std::string& commands, std::string& output, std::string& errors);
+    bool Drop(const std::string& circuitName, std::string& errors);
+
+    // Loaded circuits are never changed, so a run copies one without holding the lock
+    std::unordered_map<std::string, std::shared_ptr<const Circuit>> circuits;
+    std::shared_mutex circuitsMutex;        // Runs share it, LOAD and DROP take it alone
+    int listenFd = -1;
+    std::atomic<bool> stopping{false};
+    std::mutex clientsMutex;
+    std::condition_variable clientsDone;    // Signalled when the last client thread ends
+    std::unordered_set<int> clientFds;      // Connected clients, whose reads end when the server stops
+    size_t activeClients = 0;               // Client threads still running
+};
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef CSIMSTATS_H
+#define CSIMSTATS_H
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Gate counters are compiled in with ENABLE_STATS; when compiled in they are
+// updated without branches, so --stats only decides whether they are reported
+#ifdef ENABLE_STATS
+#define SIM_STATS(statement) statement
+#else
+#define SIM_STATS(statement)
+#endif
+
+enum class ePhase { PHASE_PARSE = 0, PHASE_BUILD, PHASE_SIMULATE, PHASE_OUTPUT, PHASE_COUNT };
+
+// Activity counters of one gate
+struct SGateCounters {
+    uint64_t drives = 0;       // Input drives received
+    uint64_t elided = 0;       // Drives skipped because the input already had the level
+    uint64_t evaluations = 0;  // Output recomputations
+    uint64_t toggles = 0;      // Evaluations that changed the output
+    uint64_t redundant = 0;    // Evaluations that left the output unchanged
+};
+
+// Simulation Statistics Class holding per-gate counters and per-phase wall time
+class CSimStats {
+public:
+    void Enable();
+    bool IsEnabled() const;
+
+    void AddGate();
+    void Remap(const std::vector<int>& newIds, size_t gateCount);
+    SGateCounters& GetCounters(int gateId) { return gateCounters[gateId]; }
+    SGateCounters GetTotals() const;
+
+    // Counter updates sit on the hot path, so they are branch-free
+    void RecordDrive(int gateId) {
+        ++gateCounters[gateId].drives;
+    }
+    void RecordElidedDrive(int gateId) {
+        SGateCounters& counters = gateCounters[gateId];
+        ++counters.drives;
+        ++counters.elided;
+    }
+    void RecordEvaluation(int gateId, bool evaluated, bool changed) {
+        SGateCounters& counters = gateCounters[gateId];
+        counters.evaluations += evaluated;
+        counters.toggles += changed;
+        counters.redundant += evaluated & !changed;
+    }
+
+    void SwitchPhase(ePhase phase);
+    void WriteJson(std::ostream& out, const std::vector<std::string>& gateNames,
+                   const std::vector<std::string>& gateTypes);
+
+private:
+    bool enabled = false;
+    std::vector<SGateCounters> gateCounters;
+    double phaseSeconds[static_cast<int>(ePhase::PHASE_COUNT)] = {};
+    ePhase currentPhase = ePhase::PHASE_PARSE;
+    std::chrono::steady_clock::time_point phaseStart;
+};
+
+#endif
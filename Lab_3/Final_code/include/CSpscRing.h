@@ -0,0 +1,65 @@
+#ifndef CSPSCRING_H
+#define CSPSCRING_H
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Bounded lock-free ring buffer for exactly one producer thread and one
+// consumer thread. Capacity is rounded up to a power of two.
+template <typename T>
+class CSpscRing {
+public:
+    explicit CSpscRing(size_t capacity) {
+        size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        slots.resize(size);
+        mask = size - 1;
+    }
+
+    // Adds an item, returning false if the ring is full
+    bool TryPush(T& item) {
+        size_t tail = tailIndex.load(std::memory_order_relaxed);
+        if (tail - headIndex.load(std::memory_order_acquire) == slots.size()) {
+            return false;
+        }
+        slots[tail & mask] = std::move(item);
+        tailIndex.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Removes the oldest item, returning false if the ring is empty
+    bool TryPop(T& item) {
+        size_t head = headIndex.load(std::memory_order_relaxed);
+        if (head == tailIndex.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = std::move(slots[head & mask]);
+        headIndex.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Blocking variants that yield while waiting for the other thread
+    void Push(T& item) {
+        while (!TryPush(item)) {
+            std::this_thread::yield();
+        }
+    }
+    void Pop(T& item) {
+        while (!TryPop(item)) {
+            std::this_thread::yield();
+        }
+    }
+
+private:
+    std::vector<T> slots;
+    size_t mask = 0;
+    alignas(64) std::atomic<size_t> headIndex{0};  // Next slot to pop, owned by the consumer
+    alignas(64) std::atomic<size_t> tailIndex{0};  // Next slot to push, owned by the producer
+};
+
+#endif
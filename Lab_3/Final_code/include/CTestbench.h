@@ -0,0 +1,134 @@
+#ifndef CTESTBENCH_H
+#define CTESTBENCH_H
+
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <queue>
+#include <string>
+#include <vector>
+#include "Circuit.h"
+
+class CTestbench;
+
+// A gate whose output a testbench process drives or watches
+struct STestbenchNet {
+    int gate = -1;
+};
+
+// A net reaching a logic level, awaited with CTestbench::Until
+struct SNetCondition {
+    int gate;
+    eLogicLevel level;
+};
+
+// Builds the condition for co_await testbench.Until(net == eLogicLevel::LOGIC_HIGH)
+inline SNetCondition operator==(STestbenchNet net, eLogicLevel level) {
+    return SNetCondition{net.gate, level};
+}
+
+// Testbench Process Class, the return type of a coroutine that drives and checks
+// the circuit. It starts suspended and runs once handed to CTestbench::Spawn.
+class CTestbenchProcess {
+public:
+    struct promise_type {
+        std::exception_ptr exception;
+
+        CTestbenchProcess get_return_object() {
+            return CTestbenchProcess(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }  // The testbench destroys finished processes
+        void return_void() {}
+        void unhandled_exception() { exception = std::current_exception(); }
+    };
+    using Handle = std::coroutine_handle<promise_type>;
+
+    explicit CTestbenchProcess(Handle handle) : handle(handle) {}
+    CTestbenchProcess(CTestbenchProcess&& other) noexcept : handle(other.handle) { other.handle = nullptr; }
+    CTestbenchProcess(const CTestbenchProcess&) = delete;
+    CTestbenchProcess& operator=(const CTestbenchProcess&) = delete;
+    ~CTestbenchProcess();
+
+private:
+    friend class CTestbench;
+    Handle handle;
+};
+
+// Testbench Class that runs coroutine processes against a circuit cooperatively
+// on one thread. A process suspends on Step until the circuit has been clocked
+// or on Until until a net reaches a level. Each round resumes every ready
+// process, then wakes the processes whose conditions hold; the clock only
+// advances once no process can run in the current cycle.
+class CTestbench {
+public:
+    // Awaiter that resumes the process a number of clock cycles later
+    struct SStepAwaiter {
+        CTestbench& testbench;
+        int cycles;
+        bool await_ready() const { return cycles <= 0; }
+        void await_suspend(CTestbenchProcess::Handle process) { testbench.WaitCycles(process, cycles); }
+        void await_resume() const {}
+    };
+
+    // Awaiter that resumes the process once a net has the awaited level
+    struct SUntilAwaiter {
+        CTestbench& testbench;
+        SNetCondition condition;
+        bool await_ready() const { return testbench.Holds(condition); }
+        void await_suspend(CTestbenchProcess::Handle process) { testbench.WaitCondition(process, condition); }
+        void await_resume() const {}
+    };
+
+    explicit CTestbench(Circuit& circuit);
+    ~CTestbench();
+    CTestbench(const CTestbench&) = delete;
+    CTestbench& operator=(const CTestbench&) = delete;
+
+    STestbenchNet Net(const std::string& gateName) const;
+    bool Drive(STestbenchNet net, int inputIndex, eLogicLevel level);
+    eLogicLevel Read(STestbenchNet net);
+    SStepAwaiter Step(int cycles = 1) { return SStepAwaiter{*this, cycles}; }
+    SUntilAwaiter Until(SNetCondition condition) { return SUntilAwaiter{*this, condition}; }
+
+    void Spawn(CTestbenchProcess process);
+    uint64_t Run(uint64_t maxCycles);
+    uint64_t GetCycle() const { return cycle; }
+    size_t GetProcessCount() const { return processCount; }
+
+private:
+    // A process waiting for the clock; ordered by wake cycle, then by arrival
+    struct SStepWaiter {
+        uint64_t wakeCycle;
+        uint64_t order;
+        CTestbenchProcess::Handle process;
+        bool operator>(const SStepWaiter& other) const {
+            return (wakeCycle != other.wakeCycle) ? wakeCycle > other.wakeCycle : order > other.order;
+        }
+    };
+
+    // A process waiting for a level on the gate it is filed under
+    struct SConditionWaiter {
+        eLogicLevel level;
+        CTestbenchProcess::Handle process;
+    };
+
+    bool Holds(const SNetCondition& condition);
+    void WaitCycles(CTestbenchProcess::Handle process, int cycles);
+    void WaitCondition(CTestbenchProcess::Handle process, const SNetCondition& condition);
+    void RunReady();
+    bool WakeConditions();
+
+    Circuit& circuit;
+    uint64_t cycle = 0;
+    size_t processCount = 0;                         // Spawned processes that have not finished
+    std::vector<CTestbenchProcess::Handle> ready;    // Resumed in order by the next round
+    std::priority_queue<SStepWaiter, std::vector<SStepWaiter>, std::greater<SStepWaiter>> stepWaiters;
+    uint64_t stepOrder = 0;
+    std::vector<std::vector<SConditionWaiter>> conditionWaiters;  // Per gate
+    std::vector<int> watchedGates;                   // Gates with condition waiters
+    std::exception_ptr failure;                      // First exception a process threw
+};
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef CTRACE_H
+#define CTRACE_H
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Trace Class that collects timed spans and writes them as a Chrome/Perfetto
+// trace-event JSON file; every thread gets its own lane
+class CTrace {
+public:
+    static CTrace& Instance();
+
+    void Start(const std::string& path);
+    bool IsEnabled() const { return enabled; }
+    double Now() const;
+    void AddSpan(const std::string& name, const char* category, double startUs, double endUs);
+    void SwitchBatch(const char* name);
+    void EndBatch();
+    void NameThread(const std::string& name);
+    bool Write();
+
+private:
+    // One completed span in microseconds since Start
+    struct SEvent {
+        std::string name;
+        const char* category;
+        double startUs;
+        double durationUs;
+        int lane;
+    };
+
+    int GetLane();
+
+    bool enabled = false;
+    std::string outputPath;
+    std::chrono::steady_clock::time_point startTime;
+    std::mutex eventsMutex;
+    std::vector<SEvent> events;
+    std::unordered_map<std::thread::id, int> lanes;
+    std::vector<std::string> laneNames;
+};
+
+// Span Class that records the time between its construction and destruction
+class CTraceSpan {
+public:
+    CTraceSpan(const char* name, const char* category = "sim");
+    ~CTraceSpan();
+
+private:
+    const char* name;
+    const char* category;
+    double startUs = -1.0;
+};
+
+#endif
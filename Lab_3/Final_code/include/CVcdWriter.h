@@ -0,0 +1,57 @@
+#ifndef CVCDWRITER_H
+#define CVCDWRITER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class CAsyncWriter;
+class Circuit;
+
+// VCD Writer Class that streams gate output changes as a Value Change Dump.
+// Output is collected in a buffer and handed to an asynchronous writer. The
+// header is written when simulation starts, so gates added after the first
+// stimulus are not dumped.
+class CVcdWriter {
+public:
+    CVcdWriter(const std::string& path, const std::vector<std::string>& nets);
+    ~CVcdWriter();
+    bool IsOpen() const;
+
+    void AdvanceTime(const Circuit& circuit);
+    void Sample(int gateId) {
+        if (static_cast<size_t>(gateId) < firstVariable.size() && firstVariable[gateId] >= 0) {
+            Record(gateId);
+        }
+    }
+    void Remap(const std::vector<int>& newIds);
+    void Close();
+
+private:
+    // One dumped signal: a gate output, or one output of a comparator
+    struct SVariable {
+        int gate;
+        int output;  // 0 for the gate output, 1..3 for greater, equal, less
+        std::string code;
+        char value;
+    };
+
+    void Begin(const Circuit& circuit);
+    void Record(int gateId);
+    char ReadValue(const SVariable& variable) const;
+    void Write(const std::string& text);
+    void Flush();
+
+    int fd = -1;
+    CAsyncWriter* writer = nullptr;
+    std::string buffer;
+    std::vector<std::string> selectedNets;     // Empty dumps every gate
+    const Circuit* circuit = nullptr;
+    std::vector<SVariable> variables;
+    std::vector<int> firstVariable;            // First variable of each gate, -1 if not dumped
+    std::vector<int> variableCount;
+    uint64_t time = 0;
+    bool timeWritten = false;
+};
+
+#endif
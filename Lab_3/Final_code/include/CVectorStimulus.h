@@ -0,0 +1,55 @@
+#ifndef CVECTORSTIMULUS_H
+#define CVECTORSTIMULUS_H
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "Circuit.h"
+
+// Vector Stimulus Class that streams a compact stimulus file through the AIG,
+// 64 vectors per bit-parallel pass. The file holds an optional header
+//     inputs <gate>.<index> ...
+// followed by one vector per line, either a bit string ("0110", first bit =
+// first input) or a hex word ("0x6", last input = least significant bit) with
+// no set bit beyond the inputs; any other line stops the run with an error.
+// Register outputs and unlisted inputs keep their current circuit levels.
+// Each vector produces one record with a bit per observed output. In activity
+// mode no records are written; instead every gate output counts how often it
+// toggles between consecutive vectors.
+class CVectorStimulus {
+public:
+    CVectorStimulus(Circuit& circuit);
+    bool Run(const std::string& path, std::ostream& out);
+    bool RunActivity(const std::string& path, std::ostream& report);
+    size_t GetVectorCount() const;
+
+private:
+    void SelectOutputs(bool allGates);
+    bool Stream(std::istream& file, std::ostream& out);
+    bool ParseHeader(const std::string& line);
+    bool ParseVector(const std::string& line, size_t lineNumber);
+    void EvaluateBatch();
+    void CountToggles();
+
+    Circuit& circuit;
+    CAig aig;
+    SAigMapping mapping;
+    bool lowered = false;                 // The circuit could be lowered into the AIG
+    std::vector<uint64_t> nodeValues;
+    std::vector<uint64_t> baseValues;     // AIG input words when no vector overrides them
+    std::vector<int> columns;             // AIG input driven by each stimulus column
+    std::vector<uint64_t> columnWords;    // Transposed stimulus: one bit per vector
+    std::vector<uint32_t> outputLiterals;
+    std::vector<std::string> outputNames;
+    std::vector<uint64_t> outputWords;
+    bool countToggles = false;
+    std::vector<uint64_t> toggleCounts;   // Activity mode: toggles per output
+    std::vector<uint64_t> lastBits;       // Activity mode: each output's level on the previous vector
+    size_t batchSize = 0;
+    size_t vectorCount = 0;
+    std::string records;
+};
+
+#endif
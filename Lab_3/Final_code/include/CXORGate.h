@@ -6,12 +6,19 @@
 // XORGate Class
 class CXORGates : public CLogicGates {
 public:
-    CXORGates();
+    CXORGates(int inputCount = 2, bool inverted = false);
     void DriveInput(int inputIndex, eLogicLevel level) override;
     eLogicLevel GetOutputState() const override;
+    CLogicGates* Clone() const override;
+    size_t GetMemoryBytes() const override;
+    void LowerToAig(CAig& aig, const std::vector<uint32_t>& inputLiterals,
+                    std::vector<uint32_t>& outputLiterals) const override;
 
 protected:
     void ComputeOutput() override;
+
+private:
+    bool inverted;  // XNOR: the output is inverted
 };
 
 #endif 
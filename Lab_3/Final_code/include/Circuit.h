@@ -1,6 +1,7 @@
 #ifndef CIRCUIT_H
 #define CIRCUIT_H
 
+#include <iostream>
 #include <unordered_map>
 #include <string>
 #include <vector>
@@ -10,19 +11,105 @@
 #include "CXORGate.h"
 #include "CNOTGate.h"
 #include "COneBitComparator.h"
+#include "CDFlipFlop.h"
+#include "CAig.h"
+#include "CSimStats.h"
+
+class CVcdWriter;
+
+// Where the signals of a circuit live inside the AIG built by Circuit::BuildAig
+struct SAigMapping {
+    // Circuit pin behind an AIG input; inputIndex -1 marks a register output
+    struct SPin {
+        int gate;
+        int inputIndex;
+    };
+
+    std::vector<SPin> inputs;                        // One pin per AIG input, in input order
+    std::vector<std::vector<uint32_t>> gateInputs;   // Literal on every input of each gate
+    std::vector<std::vector<uint32_t>> gateOutputs;  // Literal of every output of each gate
+};
 
 // Circuit class to manage gates and connections
 class Circuit {
 public:
-    void AddGate(const std::string& gateType, const std::string& gateName);
-    void DriveGate(const std::string& gateName, int inputIndex, eLogicLevel level);
-    eLogicLevel GetGateOutput(const std::string& gateName) const;
-    eLogicLevel GetComparatorOutput(const std::string& gateName, const std::string& outputType) const;
+    Circuit() = default;
+    Circuit(const Circuit& other);
+    Circuit& operator=(const Circuit&) = delete;
+    ~Circuit();
+
+    static bool IsKnownGateType(const std::string& gateType, int inputCount = 0);
+    int AddGate(const std::string& gateType, const std::string& gateName, int inputCount = 0);
+    void AddRegister(const std::string& registerName, int width);
+    void ConnectGates(const std::string& sourceName, const std::string& targetName, int inputIndex);
+    void TieInput(const std::string& gateName, int inputIndex, eLogicLevel level);
+    bool DriveGate(const std::string& gateName, int inputIndex, eLogicLevel level);
+    bool DriveGate(int gateId, int inputIndex, eLogicLevel level);
+    void Clock(int cycles);
+    void SetLazyEvaluation(bool enabled);
+    int SetConePruning(bool enabled);
+    void Settle();
+    eLogicLevel GetGateOutput(const std::string& gateName);
+    eLogicLevel GetGateOutput(int gateId);
+    eLogicLevel GetComparatorOutput(const std::string& gateName, const std::string& outputType);
+    eLogicLevel GetComparatorOutput(int gateId, const std::string& outputType);
     void AddOutputGate(const std::string& gateName);
+    int Optimize();
+    bool BuildAig(CAig& aig, SAigMapping& mapping);
+    bool SaveCheckpoint(const std::string& path);
+    bool RestoreCheckpoint(const std::string& path);
+    CSimStats& GetStats();
+    void WriteStats(std::ostream& out);
+    void WriteMemoryReport(std::ostream& out) const;
+    void SetVcdWriter(CVcdWriter* writer);
+    void SetErrorStream(std::ostream& stream) { errors = &stream; }
+    std::ostream& GetErrorStream() const { return *errors; }
+
+    int FindGate(const std::string& gateName) const;
+    int GetGateCount() const;
+    const CLogicGates* GetGate(int gateId) const;
+    const std::string& GetGateName(int gateId) const;
+    const std::string& GetGateType(int gateId) const;
+    const std::vector<std::string>& GetOutputGates() const;
 
 private:
-    std::unordered_map<std::string, CLogicGates*> gates;
+    friend class CNetlistOptimizer;
+    friend class CCheckpoint;
+
+    // A gate input fed by the output of another gate
+    struct SConnection {
+        int gate;
+        int inputIndex;
+    };
+
+    bool ApplyInput(int gateId, int inputIndex, eLogicLevel level);
+    void Propagate(int gateId);
+    void Levelize();
+    void EvaluateLevels();
+    void MarkDirty(int gateId);
+    void EvaluateCone(int gateId);
+    void SettleDirty();
+    void MarkCone(std::vector<int> pending, std::vector<bool>& inCone);
+    void ApplyCone(const std::vector<bool>& inCone);
+
+    std::unordered_map<std::string, int> gateIds;   // Gate name to index into gates
+    std::vector<CLogicGates*> gates;
+    std::vector<std::string> gateNames;
+    std::vector<uint16_t> gateTypeIds;              // Registry type id of each gate
+    std::vector<std::vector<SConnection>> fanouts;  // Gate inputs driven by each gate's output
+    std::vector<std::vector<int>> fanins;           // Source gate per input, -1 if unconnected
+    std::vector<std::vector<eLogicLevel>> tiedInputs;  // Constant level per input, undefined if not tied
+    std::vector<int> registers;                     // Flip-flops latched on every clock
+    std::vector<int> evalOrder;                     // Gates in level order for clocked evaluation
+    bool levelsDirty = true;
+    bool lazyEvaluation = false;
+    std::vector<bool> dirty;                        // Gates whose output is stale in lazy mode
+    bool conePruning = false;
+    std::vector<bool> pruned;                       // Gates outside the observed outputs' fan-in cone
     std::vector<std::string> outputGates;  // Holds the gates marked for output
+    CSimStats stats;
+    CVcdWriter* vcdWriter = nullptr;                // Receives output changes when dumping
+    std::ostream* errors = &std::cerr;              // Receives error messages
 };
 
 #endif
@@ -1,12 +1,210 @@
  // SID: 520534445
  // Lab 3: Refactoring and Design 
 
+#include "CAsyncWriter.h"
+#include "CBatchRunner.h"
+#include "CCommandLog.h"
 #include "CFileReader.h"
+#include "CPartitionedSim.h"
+#include "CSimClient.h"
+#include "CSimServer.h"
+#include "CTrace.h"
+#include "CVcdWriter.h"
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+// Prints the command-line forms of the simulator
+static void PrintUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [--pipeline] [--async-output] [--stats[=file]] [--trace=file] [--vcd=file [--vcd-nets=a,b]] [--command-log=file | --replay=file] < circuit.txt\n"
+              << "       " << program << " --partitions=k < circuit.txt\n"
+              << "       " << program << " --batch=list.txt [--jobs=n] [--out-dir=dir] [--trace=file]\n"
+              << "       " << program << " --serve=socket\n"
+              << "       " << program << " --connect=socket (--load=name | --circuit=name | --shutdown) < commands.txt" << std::endl;
+}
+
+// Parses the non-negative count of a --name=count option; returns false and reports it if malformed
+static bool ParseCount(const std::string& option, size_t prefixLength, int& count) {
+    const char* text = option.c_str() + prefixLength;
+    char* end = nullptr;
+    errno = 0;
+    long value = std::strtol(text, &end, 10);
+    if (end == text || *end != '\0' || errno == ERANGE || value < 0 || value > INT_MAX) {
+        std::cerr << "Error: " << option.substr(0, prefixLength - 1) << " needs a count of 0 or more, not '" 
+                  << text << "'." << std::endl;
+        return false;
+    }
+    count = static_cast<int>(value);
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    bool writeStats = false;
+    bool pipeline = false;                  // Parse, simulate and format on separate threads
+    bool asyncOutput = false;               // Write stdout through io_uring in large blocks
+    std::string statsPath;                  // Empty writes the statistics to stderr
+    std::string vcdPath;
+    std::vector<std::string> vcdNets;       // Empty dumps every gate
+    std::string servePath;                  // Socket to serve on
+    std::string connectPath;                // Socket of a running server to send stdin to
+    std::string loadName, runName;
+    bool shutdown = false;
+    std::string batchPath;                  // List of circuit files to simulate concurrently
+    std::string outputDirectory;            // Per-file outputs for batch mode, empty merges them
+    int jobs = 0;                           // Batch worker threads, 0 uses every core
+    int partitions = 0;                     // Worker processes for a partitioned netlist, 0 runs in-process
+    std::string commandLogPath;             // Binary log that receives every parsed command
+    std::string replayPath;                 // Binary log replayed instead of reading stdin
+    for (int arg = 1; arg < argc; ++arg) {
+        std::string option = argv[arg];
+        if (option == "--pipeline") {
+            pipeline = true;
+        } else if (option == "--async-output") {
+            asyncOutput = true;
+        } else if (option == "--stats") {
+            writeStats = true;
+        } else if (option.rfind("--stats=", 0) == 0) {
+            writeStats = true;
+            statsPath = option.substr(8);
+        } else if (option.rfind("--trace=", 0) == 0) {
+            CTrace::Instance().Start(option.substr(8));  // Record a Chrome trace-event timeline
+        } else if (option.rfind("--vcd=", 0) == 0) {
+            vcdPath = option.substr(6);
+        } else if (option.rfind("--vcd-nets=", 0) == 0) {
+            std::istringstream nets(option.substr(11));
+            std::string net;
+            while (std::getline(nets, net, ',')) {
+                vcdNets.push_back(net);
+            }
+        } else if (option.rfind("--serve=", 0) == 0) {
+            servePath = option.substr(8);
+        } else if (option.rfind("--connect=", 0) == 0) {
+            connectPath = option.substr(10);
+        } else if (option.rfind("--load=", 0) == 0) {
+            loadName = option.substr(7);
+        } else if (option.rfind("--circuit=", 0) == 0) {
+            runName = option.substr(10);
+        } else if (option == "--shutdown") {
+            shutdown = true;
+        } else if (option.rfind("--batch=", 0) == 0) {
+            batchPath = option.substr(8);
+        } else if (option.rfind("--jobs=", 0) == 0) {
+            if (!ParseCount(option, 7, jobs)) {
+                PrintUsage(argv[0]);
+                return 1;
+            }
+        } else if (option.rfind("--out-dir=", 0) == 0) {
+            outputDirectory = option.substr(10);
+        } else if (option.rfind("--partitions=", 0) == 0) {
+            if (!ParseCount(option, 13, partitions)) {
+                PrintUsage(argv[0]);
+                return 1;
+            }
+        } else if (option.rfind("--command-log=", 0) == 0) {
+            commandLogPath = option.substr(14);
+        } else if (option.rfind("--replay=", 0) == 0) {
+            replayPath = option.substr(9);
+        } else {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (!batchPath.empty()) {
+        std::vector<std::string> circuitPaths;
+        if (!CBatchRunner::ReadList(batchPath, circuitPaths)) {
+            return 1;
+        }
+        CBatchRunner batchRunner(circuitPaths);
+        int failures = batchRunner.Run(jobs, outputDirectory);  // One Circuit per file on a thread pool
+        bool traced = CTrace::Instance().Write();
+        return (failures == 0 && traced) ? 0 : 1;
+    }
+    if (!servePath.empty()) {
+        CSimServer server;                  // Stay resident and keep loaded circuits cached
+        return server.Serve(servePath) ? 0 : 1;
+    }
+    if (!connectPath.empty()) {
+        CSimClient client;
+        SSimReply reply;
+        if (!client.Connect(connectPath)) {
+            return 1;
+        }
+        if (shutdown) {
+            return client.Shutdown() ? 0 : 1;
+        }
+        std::ostringstream commands;
+        commands << std::cin.rdbuf();
+        bool sent = loadName.empty() ? client.Run(runName, commands.str(), reply) 
+                                     : client.Load(loadName, commands.str(), reply);
+        std::cout << reply.output;
+        std::cerr << reply.errors;
+        return (sent && reply.ok) ? 0 : 1;
+    }
+
+    if (partitions > 0) {
+        CPartitionedSim partitionedSim(partitions);  // One worker process per part of the netlist
+        bool ok = partitionedSim.Run(std::cin, std::cout);
+        std::cerr << "Partitioned simulation: " << partitionedSim.GetCutNetCount() << " cut nets" << std::endl;
+        return ok ? 0 : 1;
+    }
+
+    if (pipeline) {
+        std::ios::sync_with_stdio(false);   // Lets the parser see how much input is buffered
+    }
+
+    CCommandLog commandLog;
+    if (!replayPath.empty() && !commandLog.Load(replayPath)) {
+        return 1;
+    }
+    if (replayPath.empty() && !commandLogPath.empty() && !commandLog.Create(commandLogPath)) {
+        return 1;
+    }
 
-int main() {
     Circuit myCircuit;                      // Create an instance of Circuit to manage gates
-    CFileReader fileReader(myCircuit);      // Initialize file reader with the circuit instance
-    fileReader.ProcessInput();              // Process input commands for building and simulating the circuit
+    if (writeStats) {
+        myCircuit.GetStats().Enable();      // Time each phase for the report
+    }
+    CVcdWriter* vcdWriter = vcdPath.empty() ? nullptr : new CVcdWriter(vcdPath, vcdNets);
+    if (vcdWriter && vcdWriter->IsOpen()) {
+        myCircuit.SetVcdWriter(vcdWriter);  // Dump output changes while simulating
+    }
+    CAsyncWriter* asyncWriter = asyncOutput ? new CAsyncWriter(STDOUT_FILENO) : nullptr;
+    std::ostream asyncStream(asyncWriter);
+    CFileReader fileReader(myCircuit, std::cin, asyncWriter ? asyncStream : std::cout);  // Initialize file reader with the circuit instance
+    if (!replayPath.empty()) {
+        fileReader.ReplayFrom(&commandLog);  // Commands come pre-parsed from the log
+    } else if (!commandLogPath.empty()) {
+        fileReader.RecordTo(&commandLog);
+    }
+    if (pipeline) {
+        fileReader.ProcessInputPipelined();
+    } else {
+        fileReader.ProcessInput();          // Process input commands for building and simulating the circuit
+    }
+
+    bool statsWritten = true;
+    if (writeStats && statsPath.empty()) {
+        myCircuit.WriteStats(std::cerr);    // Dump counters and phase times as JSON
+    } else if (writeStats) {
+        std::ofstream statsFile(statsPath);
+        myCircuit.WriteStats(statsFile);
+        statsWritten = static_cast<bool>(statsFile.flush());
+        if (!statsWritten) {
+            std::cerr << "Error: Cannot write statistics file " << statsPath << std::endl;
+        }
+    }
+
+    bool traced = CTrace::Instance().Write();
+    delete vcdWriter;                       // Flushes and closes the dump
+    bool written = !asyncWriter || asyncWriter->Close();
+    delete asyncWriter;
 
-    return 0;
+    return (commandLog.Close() && written && statsWritten && traced) ? 0 : 1;
 }
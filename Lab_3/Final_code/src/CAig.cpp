@@ -0,0 +1,85 @@
+#include "CAig.h"
+#include <iostream>
+#include <utility>
+
+// Adds a primary input; all inputs must be added before the first AND node
+uint32_t CAig::AddInput() {
+    if (!ands.empty()) {
+        std::cerr << "Error: AIG inputs must be added before AND nodes." << std::endl;
+        return LITERAL_FALSE;
+    }
+    ++inputCount;
+    return inputCount * 2;
+}
+
+// Adds an AND node, reusing an identical node and folding trivial cases
+uint32_t CAig::AddAnd(uint32_t literal0, uint32_t literal1) {
+    if (literal0 > literal1) {
+        std::swap(literal0, literal1);
+    }
+    if (literal0 == LITERAL_FALSE || literal0 == Not(literal1)) {
+        return LITERAL_FALSE;
+    }
+    if (literal0 == LITERAL_TRUE || literal0 == literal1) {
+        return literal1;
+    }
+
+    uint64_t key = (static_cast<uint64_t>(literal0) << 32) | literal1;
+    auto existing = structuralHash.find(key);
+    if (existing != structuralHash.end()) {
+        return existing->second;
+    }
+
+    uint32_t literal = static_cast<uint32_t>(GetNodeCount()) * 2;
+    ands.push_back({literal0, literal1});
+    structuralHash.emplace(key, literal);
+    return literal;
+}
+
+// Adds an OR as an inverted AND of inverted inputs
+uint32_t CAig::AddOr(uint32_t literal0, uint32_t literal1) {
+    return Not(AddAnd(Not(literal0), Not(literal1)));
+}
+
+// Adds an XOR built from three AND nodes
+uint32_t CAig::AddXor(uint32_t literal0, uint32_t literal1) {
+    return AddOr(AddAnd(literal0, Not(literal1)), AddAnd(Not(literal0), literal1));
+}
+
+// Returns the number of primary inputs
+size_t CAig::GetInputCount() const {
+    return inputCount;
+}
+
+// Returns the number of AND nodes
+size_t CAig::GetAndCount() const {
+    return ands.size();
+}
+
+// Returns the number of nodes including the constant node
+size_t CAig::GetNodeCount() const {
+    return 1 + inputCount + ands.size();
+}
+
+// Returns the bytes held by the node array
+size_t CAig::GetMemoryBytes() const {
+    return ands.capacity() * sizeof(SAndNode);
+}
+
+// Evaluates 64 patterns at once; nodeValues must hold GetNodeCount() words with
+// the inputs already set, and receives the value of every AND node
+void CAig::Simulate(std::vector<uint64_t>& nodeValues) const {
+    uint64_t* values = nodeValues.data();
+    values[0] = 0;
+    uint64_t* output = values + 1 + inputCount;
+    for (const SAndNode& node : ands) {
+        uint64_t value0 = values[node.fanin0 >> 1] ^ (0 - static_cast<uint64_t>(node.fanin0 & 1u));
+        uint64_t value1 = values[node.fanin1 >> 1] ^ (0 - static_cast<uint64_t>(node.fanin1 & 1u));
+        *output++ = value0 & value1;
+    }
+}
+
+// Returns the 64 pattern values of a literal after Simulate
+uint64_t CAig::GetLiteralValue(const std::vector<uint64_t>& nodeValues, uint32_t literal) {
+    return nodeValues[literal >> 1] ^ (0 - static_cast<uint64_t>(literal & 1u));
+}
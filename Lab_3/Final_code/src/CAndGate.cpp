@@ -1,8 +1,9 @@
 #include "CAndGate.h"
+#include "CAig.h"
 
-// Constructor to initialize AND gate with two undefined inputs
-CAndGates::CAndGates() {
-    inputs.resize(2, eLogicLevel::LOGIC_UNDEFINED);
+// Constructor to initialize AND gate (NAND when inverted) with undefined inputs
+CAndGates::CAndGates(int inputCount, bool inverted) : inverted(inverted) {
+    SetInputCount(inputCount);
 }
 
 // Sets the logic level of a specific input and recomputes the output
@@ -16,8 +17,32 @@ eLogicLevel CAndGates::GetOutputState() const {
     return outputValue;
 }
 
-// Computes the AND gate's output based on its two inputs
+// Returns a copy of the gate including its current input and output levels
+CLogicGates* CAndGates::Clone() const {
+    return new CAndGates(*this);
+}
+
+// Returns the bytes the gate occupies; its inputs are stored inline
+size_t CAndGates::GetMemoryBytes() const {
+    return sizeof(*this) + GetInputHeapBytes();
+}
+
+// Computes the AND gate's output: high only if every input is high. The loop
+// has no early exit so the compiler can vectorize it over the input span.
 void CAndGates::ComputeOutput() {
-    outputValue = (inputs[0] == eLogicLevel::LOGIC_HIGH && inputs[1] == eLogicLevel::LOGIC_HIGH) 
-                    ? eLogicLevel::LOGIC_HIGH : eLogicLevel::LOGIC_LOW;
+    bool allHigh = true;
+    for (int inputIndex = 0; inputIndex < inputCount; ++inputIndex) {
+        allHigh &= (inputs[inputIndex] == eLogicLevel::LOGIC_HIGH);
+    }
+    outputValue = (allHigh != inverted) ? eLogicLevel::LOGIC_HIGH : eLogicLevel::LOGIC_LOW;
+}
+
+// Lowers the AND gate into the AND-inverter graph
+void CAndGates::LowerToAig(CAig& aig, const std::vector<uint32_t>& inputLiterals,
+                           std::vector<uint32_t>& outputLiterals) const {
+    uint32_t literal = inputLiterals[0];
+    for (size_t input = 1; input < inputLiterals.size(); ++input) {
+        literal = aig.AddAnd(literal, inputLiterals[input]);
+    }
+    outputLiterals.assign(1, inverted ? CAig::Not(literal) : literal);
 }
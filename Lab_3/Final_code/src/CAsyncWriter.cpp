@@ -0,0 +1,260 @@
+#include "CAsyncWriter.h"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <iostream>
+#include <unistd.h>
+#ifdef HAVE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+static const size_t OUTPUT_BUFFER = 1 << 20;  // Bytes per buffer; one fills while the other is written
+static const unsigned RING_ENTRIES = 2;       // Only one write is ever in flight
+
+// Constructor that sets up the ring, or plain writes if io_uring is unavailable or not wanted
+CAsyncWriter::CAsyncWriter(int fd, bool useRing) : fd(fd) {
+    buffers[0].resize(OUTPUT_BUFFER);
+    buffers[1].resize(OUTPUT_BUFFER);
+    setp(buffers[0].data(), buffers[0].data() + OUTPUT_BUFFER);
+    if (useRing && !SetupRing()) {
+        CloseRing();
+    }
+}
+
+// Destructor that writes everything still buffered
+CAsyncWriter::~CAsyncWriter() {
+    Close();
+    CloseRing();
+}
+
+// Writes everything buffered and waits until the kernel has it; returns false if any write failed
+bool CAsyncWriter::Close() {
+    Submit();
+    WaitWrite();
+    return !failed;
+}
+
+// Called when the buffer is full: hands it to the kernel and continues in the other one
+int CAsyncWriter::overflow(int c) {
+    Submit();
+    if (c != traits_type::eof()) {
+        *pptr() = static_cast<char>(c);
+        pbump(1);
+    }
+    return failed ? traits_type::eof() : traits_type::not_eof(c);
+}
+
+// Copies a block into the buffers, submitting each buffer as it fills
+std::streamsize CAsyncWriter::xsputn(const char* data, std::streamsize size) {
+    std::streamsize copied = 0;
+    while (copied < size) {
+        std::streamsize room = epptr() - pptr();
+        if (room == 0) {
+            Submit();
+            continue;
+        }
+        std::streamsize chunk = std::min(room, size - copied);
+        std::memcpy(pptr(), data + copied, static_cast<size_t>(chunk));
+        pbump(static_cast<int>(chunk));
+        copied += chunk;
+    }
+    return size;
+}
+
+// Flushing submits the buffered output without waiting for the write to finish
+int CAsyncWriter::sync() {
+    Submit();
+    return failed ? -1 : 0;
+}
+
+// Starts writing the active buffer once the previous write is done, then switches buffers
+void CAsyncWriter::Submit() {
+    size_t size = static_cast<size_t>(pptr() - pbase());
+    if (size == 0) {
+        return;
+    }
+    WaitWrite();
+    StartWrite(pbase(), size);
+    active ^= 1;
+    setp(buffers[active].data(), buffers[active].data() + OUTPUT_BUFFER);
+}
+
+// Writes without the ring, retrying short writes; reports the first failure
+void CAsyncWriter::WriteDirect(const char* data, size_t size) {
+    while (size > 0 && !failed) {
+        ssize_t written = write(fd, data, size);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            std::cerr << "Error: Cannot write output: " << std::strerror(errno) << std::endl;
+            failed = true;
+            break;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+}
+
+#ifdef HAVE_IO_URING
+// Creates the ring and maps its queues; returns false if the kernel cannot provide one
+bool CAsyncWriter::SetupRing() {
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    ringFd = static_cast<int>(syscall(__NR_io_uring_setup, RING_ENTRIES, &params));
+    if (ringFd < 0 || !(params.features & IORING_FEAT_RW_CUR_POS)) {
+        return false;  // Writes must follow the file position, since pipes have no offset
+    }
+    ringBytes = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    size_t completionRingBytes = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool singleMapping = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMapping) {
+        ringBytes = std::max(ringBytes, completionRingBytes);
+    }
+    ringMemory = mmap(nullptr, ringBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+    if (ringMemory == MAP_FAILED) {
+        ringMemory = nullptr;
+        return false;
+    }
+    void* completions = ringMemory;
+    if (!singleMapping) {
+        completionBytes = completionRingBytes;
+        completionMemory = mmap(nullptr, completionBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                ringFd, IORING_OFF_CQ_RING);
+        if (completionMemory == MAP_FAILED) {
+            completionMemory = nullptr;
+            return false;
+        }
+        completions = completionMemory;
+    }
+    entryBytes = params.sq_entries * sizeof(io_uring_sqe);
+    entryMemory = mmap(nullptr, entryBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+    if (entryMemory == MAP_FAILED) {
+        entryMemory = nullptr;
+        return false;
+    }
+
+    char* submissionRing = static_cast<char*>(ringMemory);
+    char* completionRing = static_cast<char*>(completions);
+    submitTail = reinterpret_cast<unsigned*>(submissionRing + params.sq_off.tail);
+    submitMask = reinterpret_cast<unsigned*>(submissionRing + params.sq_off.ring_mask);
+    submitArray = reinterpret_cast<unsigned*>(submissionRing + params.sq_off.array);
+    completeHead = reinterpret_cast<unsigned*>(completionRing + params.cq_off.head);
+    completeTail = reinterpret_cast<unsigned*>(completionRing + params.cq_off.tail);
+    completeMask = reinterpret_cast<unsigned*>(completionRing + params.cq_off.ring_mask);
+    completionEntries = completionRing + params.cq_off.cqes;
+    return true;
+}
+
+// Unmaps the queues and closes the ring; later output is written directly
+void CAsyncWriter::CloseRing() {
+    if (entryMemory) {
+        munmap(entryMemory, entryBytes);
+    }
+    if (completionMemory) {
+        munmap(completionMemory, completionBytes);
+    }
+    if (ringMemory) {
+        munmap(ringMemory, ringBytes);
+    }
+    if (ringFd >= 0) {
+        close(ringFd);
+    }
+    entryMemory = completionMemory = ringMemory = nullptr;
+    ringFd = -1;
+}
+
+// Queues a write of the pending bytes at the current file position and submits it
+void CAsyncWriter::QueueWrite() {
+    unsigned tail = *submitTail;
+    unsigned index = tail & *submitMask;
+    io_uring_sqe* entry = static_cast<io_uring_sqe*>(entryMemory) + index;
+    std::memset(entry, 0, sizeof(*entry));
+    entry->opcode = IORING_OP_WRITE;
+    entry->fd = fd;
+    entry->off = ~0ULL;  // -1 writes at the file position, like write
+    entry->addr = reinterpret_cast<uint64_t>(pendingData);
+    entry->len = static_cast<unsigned>(std::min<size_t>(pendingSize, UINT_MAX));
+    submitArray[index] = index;
+    __atomic_store_n(submitTail, tail + 1, __ATOMIC_RELEASE);
+    while (syscall(__NR_io_uring_enter, ringFd, 1, 0, 0, nullptr, 0) < 0) {
+        if (errno != EINTR) {
+            FallBack();
+            return;
+        }
+    }
+}
+
+// Returns the result of the next completed write, waiting for it if needed
+bool CAsyncWriter::ReapWrite(int& result) {
+    unsigned head = *completeHead;
+    while (head == __atomic_load_n(completeTail, __ATOMIC_ACQUIRE)) {
+        if (syscall(__NR_io_uring_enter, ringFd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 && errno != EINTR) {
+            return false;
+        }
+    }
+    result = static_cast<const io_uring_cqe*>(completionEntries)[head & *completeMask].res;
+    __atomic_store_n(completeHead, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+#else
+// io_uring is not available at build time, so output is always written directly
+bool CAsyncWriter::SetupRing() {
+    return false;
+}
+
+// Nothing to release without a ring
+void CAsyncWriter::CloseRing() {}
+
+// Unreachable without a ring
+void CAsyncWriter::QueueWrite() {
+    FallBack();
+}
+
+// Unreachable without a ring
+bool CAsyncWriter::ReapWrite(int& result) {
+    return false;
+}
+#endif
+
+// Starts writing a buffer through the ring, or writes it directly without one
+void CAsyncWriter::StartWrite(const char* data, size_t size) {
+    if (ringFd < 0) {
+        WriteDirect(data, size);
+        return;
+    }
+    pendingData = data;
+    pendingSize = size;
+    QueueWrite();
+}
+
+// Waits for the write in flight to finish, resubmitting what a short write left over
+void CAsyncWriter::WaitWrite() {
+    while (pendingSize > 0 && ringFd >= 0) {
+        int result = 0;
+        if (!ReapWrite(result)) {
+            FallBack();
+            return;
+        }
+        if (result > 0) {
+            pendingData += result;
+            pendingSize -= static_cast<size_t>(result);
+        } else if (result != -EINTR && result != -EAGAIN) {
+            FallBack();  // Also reports a real error through the plain write
+            return;
+        }
+        if (pendingSize > 0) {
+            QueueWrite();
+        }
+    }
+}
+
+// Gives up on the ring and writes what is pending directly
+void CAsyncWriter::FallBack() {
+    CloseRing();
+    WriteDirect(pendingData, pendingSize);
+    pendingSize = 0;
+}
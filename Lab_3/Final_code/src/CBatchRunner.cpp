@@ -0,0 +1,121 @@
+#include "CBatchRunner.h"
+#include "CFileReader.h"
+#include "CTrace.h"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+// Returns the file name of a path without its directories and extension
+static std::string BaseName(const std::string& path) {
+    size_t slash = path.find_last_of('/');
+    std::string name = (slash == std::string::npos) ? path : path.substr(slash + 1);
+    size_t dot = name.find_last_of('.');
+    return (dot == std::string::npos || dot == 0) ? name : name.substr(0, dot);
+}
+
+// Constructor that takes the circuit files to simulate
+CBatchRunner::CBatchRunner(const std::vector<std::string>& circuitPaths) : circuitPaths(circuitPaths) {}
+
+// Reads one circuit path per line, skipping blank lines and # comments
+bool CBatchRunner::ReadList(const std::string& listPath, std::vector<std::string>& circuitPaths) {
+    std::ifstream list(listPath);
+    if (!list) {
+        std::cerr << "Error: Cannot open batch list " << listPath << std::endl;
+        return false;
+    }
+    std::string line;
+    while (std::getline(list, line)) {
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') {
+            continue;
+        }
+        size_t last = line.find_last_not_of(" \t\r");
+        circuitPaths.push_back(line.substr(first, last - first + 1));
+    }
+    return true;
+}
+
+// Simulates every circuit on up to jobs threads and returns the number that failed.
+// With an output directory the circuit at list position n writes <n>_<name>.out
+// there, so files with the same name in different directories do not collide;
+// otherwise outputs are written to merged in list order, each after a "# <path>" line.
+int CBatchRunner::Run(int jobs, const std::string& outputDirectory, std::ostream& merged) {
+    if (jobs < 1) {
+        jobs = std::max(1u, std::thread::hardware_concurrency());
+    }
+    jobs = std::min<int>(jobs, static_cast<int>(circuitPaths.size()));
+
+    std::atomic<size_t> nextTask{0};
+    std::atomic<int> failures{0};
+    std::vector<std::string> outputs(circuitPaths.size());
+    std::vector<bool> finished(circuitPaths.size(), false);
+    size_t nextMerged = 0;  // First task whose output has not been written to merged
+    std::mutex mergeMutex;
+
+    auto worker = [&](int workerIndex) {
+        CTrace::Instance().NameThread("batch worker " + std::to_string(workerIndex));
+        for (size_t task = nextTask++; task < circuitPaths.size(); task = nextTask++) {
+            std::string output;
+            if (!RunTask(task, outputDirectory, output)) {
+                ++failures;
+            }
+            if (!outputDirectory.empty()) {
+                continue;
+            }
+
+            // Write every finished task that is next in list order
+            std::lock_guard<std::mutex> lock(mergeMutex);
+            outputs[task].swap(output);
+            finished[task] = true;
+            while (nextMerged < circuitPaths.size() && finished[nextMerged]) {
+                merged << "# " << circuitPaths[nextMerged] << '\n' << outputs[nextMerged];
+                std::string().swap(outputs[nextMerged]);
+                ++nextMerged;
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int workerIndex = 1; workerIndex < jobs; ++workerIndex) {
+        workers.emplace_back(worker, workerIndex);
+    }
+    worker(0);  // The calling thread works too
+    for (std::thread& thread : workers) {
+        thread.join();
+    }
+    merged.flush();
+    return failures;
+}
+
+// Simulates one circuit file into its output file, or into output when merging
+bool CBatchRunner::RunTask(size_t task, const std::string& outputDirectory, std::string& output) {
+    const std::string& path = circuitPaths[task];
+    CTraceSpan span(path.c_str(), "batch");
+    std::ifstream input(path);
+    if (!input) {
+        std::cerr << "Error: Cannot open circuit file " << path << std::endl;
+        return false;
+    }
+
+    Circuit circuit;
+    if (outputDirectory.empty()) {
+        std::ostringstream printed;
+        CFileReader fileReader(circuit, input, printed);
+        fileReader.ProcessInput();
+        output = printed.str();
+        return true;
+    }
+
+    std::string outputPath = outputDirectory + "/" + std::to_string(task + 1) + "_" + BaseName(path) + ".out";
+    std::ofstream printed(outputPath);
+    if (!printed) {
+        std::cerr << "Error: Cannot write output file " << outputPath << std::endl;
+        return false;
+    }
+    CFileReader fileReader(circuit, input, printed);
+    fileReader.ProcessInput();
+    return true;
+}
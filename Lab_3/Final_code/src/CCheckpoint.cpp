@@ -0,0 +1,166 @@
+#include "CCheckpoint.h"
+#include "CTrace.h"
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+static const char CHECKPOINT_MAGIC[8] = {'S', 'I', 'M', 'C', 'K', 'P', 'T', '\0'};
+static const uint32_t CHECKPOINT_VERSION = 2;  // Version 1 also stored a lazy dirty flag per gate
+static const uint64_t FNV_OFFSET = 1469598103934665603ULL;
+static const uint64_t FNV_PRIME = 1099511628211ULL;
+
+// Folds bytes into an FNV-1a hash
+static void HashBytes(uint64_t& hash, const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * FNV_PRIME;
+    }
+}
+
+// Folds a string and its terminator into an FNV-1a hash
+static void HashString(uint64_t& hash, const std::string& text) {
+    HashBytes(hash, text.c_str(), text.size() + 1);
+}
+
+// Folds an integer into an FNV-1a hash
+static void HashInt(uint64_t& hash, int64_t value) {
+    HashBytes(hash, &value, sizeof(value));
+}
+
+// Constructor that attaches the checkpoint to a circuit
+CCheckpoint::CCheckpoint(Circuit& circuit) : circuit(circuit) {}
+
+// Hashes gate names, types, connections and tied inputs, everything that shapes the state
+uint64_t CCheckpoint::NetlistHash() const {
+    uint64_t hash = FNV_OFFSET;
+    HashInt(hash, circuit.GetGateCount());
+    for (int gateId = 0; gateId < circuit.GetGateCount(); ++gateId) {
+        HashString(hash, circuit.gateNames[gateId]);
+        HashString(hash, circuit.GetGateType(gateId));
+        for (const Circuit::SConnection& connection : circuit.fanouts[gateId]) {
+            HashInt(hash, connection.gate);
+            HashInt(hash, connection.inputIndex);
+        }
+        HashInt(hash, -1);  // Ends this gate's fanout
+        for (eLogicLevel level : circuit.tiedInputs[gateId]) {
+            HashInt(hash, static_cast<int>(level));
+        }
+    }
+    return hash;
+}
+
+// Returns the number of levels stored: every input and every held output
+uint64_t CCheckpoint::LevelCount() const {
+    uint64_t count = 0;
+    for (const CLogicGates* gate : circuit.gates) {
+        count += gate->GetInputCount() + gate->GetStateCount();
+    }
+    return count;
+}
+
+// Writes the header and one signed byte per level; returns false if the file cannot be written.
+// Lazy gates are settled first, so the image never holds stale levels.
+bool CCheckpoint::Save(const std::string& path) const {
+    CTraceSpan span("SaveCheckpoint", "checkpoint");
+    circuit.SettleDirty();
+
+    SHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic));
+    header.version = CHECKPOINT_VERSION;
+    header.gateCount = static_cast<uint32_t>(circuit.GetGateCount());
+    header.netlistHash = NetlistHash();
+    header.levelCount = LevelCount();
+    header.lazyEvaluation = circuit.lazyEvaluation ? 1 : 0;
+
+    std::vector<int8_t> levels;
+    levels.reserve(header.levelCount);
+    for (int gateId = 0; gateId < circuit.GetGateCount(); ++gateId) {
+        const CLogicGates* gate = circuit.gates[gateId];
+        for (int inputIndex = 0; inputIndex < gate->GetInputCount(); ++inputIndex) {
+            levels.push_back(static_cast<int8_t>(gate->GetInput(inputIndex)));
+        }
+        for (int stateIndex = 0; stateIndex < gate->GetStateCount(); ++stateIndex) {
+            levels.push_back(static_cast<int8_t>(gate->GetState(stateIndex)));
+        }
+    }
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        circuit.GetErrorStream() << "Error: Cannot write checkpoint " << path << std::endl;
+        return false;
+    }
+    bool written = std::fwrite(&header, sizeof(header), 1, file) == 1 
+                && std::fwrite(levels.data(), 1, levels.size(), file) == levels.size();
+    written = (std::fclose(file) == 0) && written;
+    if (!written) {
+        circuit.GetErrorStream() << "Error: Cannot write checkpoint " << path << std::endl;
+    }
+    return written;
+}
+
+// Maps an image and copies its levels into the gates; the circuit is unchanged if the image does not fit
+bool CCheckpoint::Restore(const std::string& path) {
+    CTraceSpan span("RestoreCheckpoint", "checkpoint");
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        circuit.GetErrorStream() << "Error: Cannot open checkpoint " << path << std::endl;
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) < 0 || static_cast<size_t>(info.st_size) < sizeof(SHeader)) {
+        circuit.GetErrorStream() << "Error: Checkpoint " << path << " is truncated." << std::endl;
+        close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        circuit.GetErrorStream() << "Error: Cannot map checkpoint " << path << std::endl;
+        return false;
+    }
+
+    SHeader header;
+    std::memcpy(&header, mapping, sizeof(header));
+    const int8_t* levels = static_cast<const int8_t*>(mapping) + sizeof(SHeader);
+    bool valid = false;
+    if (std::memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic)) != 0 
+        || header.version != CHECKPOINT_VERSION) {
+        circuit.GetErrorStream() << "Error: " << path << " is not a checkpoint." << std::endl;
+    } else if (header.gateCount != static_cast<uint32_t>(circuit.GetGateCount()) 
+               || header.netlistHash != NetlistHash()) {
+        circuit.GetErrorStream() << "Error: Checkpoint " << path << " was saved from a different netlist." << std::endl;
+    } else if (header.levelCount != LevelCount() || size - sizeof(SHeader) < header.levelCount) {
+        circuit.GetErrorStream() << "Error: Checkpoint " << path << " is truncated." << std::endl;
+    } else {
+        valid = true;
+        for (uint64_t index = 0; index < header.levelCount && valid; ++index) {
+            valid = (levels[index] >= -1 && levels[index] <= 1);
+        }
+        if (!valid) {
+            circuit.GetErrorStream() << "Error: Checkpoint " << path << " holds an invalid logic level." << std::endl;
+        }
+    }
+
+    if (valid) {
+        for (int gateId = 0; gateId < circuit.GetGateCount(); ++gateId) {
+            CLogicGates* gate = circuit.gates[gateId];
+            for (int inputIndex = 0; inputIndex < gate->GetInputCount(); ++inputIndex) {
+                gate->SetInput(inputIndex, static_cast<eLogicLevel>(*levels++));
+            }
+            for (int stateIndex = 0; stateIndex < gate->GetStateCount(); ++stateIndex) {
+                gate->SetState(stateIndex, static_cast<eLogicLevel>(*levels++));
+            }
+            circuit.dirty[gateId] = false;  // The image was settled when it was saved
+        }
+        circuit.lazyEvaluation = (header.lazyEvaluation != 0);
+    }
+    munmap(mapping, size);
+    return valid;
+}
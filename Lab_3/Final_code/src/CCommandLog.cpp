@@ -0,0 +1,190 @@
+#include "CCommandLog.h"
+#include "CTrace.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+static const char LOG_MAGIC[8] = {'S', 'I', 'M', 'C', 'L', 'O', 'G', '\0'};
+static const uint32_t LOG_VERSION = 1;
+static const size_t LOG_BUFFER = 1 << 16;     // Encoded bytes collected before they are written
+static const unsigned char STRING_TAG = 0xFF;  // Defines the next string id; no command byte has every bit set
+static const int LEVEL_SHIFT = 5;              // Command byte: type in the low bits, level code above
+static const int LEVEL_ESCAPE = 3;             // Level code for a level other than -1, 0 or 1, stored after the fields
+
+// Maps a signed integer to an unsigned one so small magnitudes encode in few bytes
+static uint64_t ZigZag(int value) {
+    return (static_cast<uint64_t>(static_cast<int64_t>(value)) << 1) ^ static_cast<uint64_t>(static_cast<int64_t>(value) >> 63);
+}
+
+// Undoes ZigZag
+static int UnZigZag(uint64_t value) {
+    return static_cast<int>(static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1));
+}
+
+// Destructor that finishes a log still being recorded
+CCommandLog::~CCommandLog() {
+    Close();
+}
+
+// Starts recording into a new log; returns false if the file cannot be created
+bool CCommandLog::Create(const std::string& path) {
+    Close();
+    logPath = path;
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Error: Cannot write command log " << path << std::endl;
+        return false;
+    }
+    failed = false;
+    stringIds.clear();
+    pending.assign(LOG_MAGIC, sizeof(LOG_MAGIC));
+    pending.append(reinterpret_cast<const char*>(&LOG_VERSION), sizeof(LOG_VERSION));
+    return true;
+}
+
+// Appends one command, defining any string it names for the first time
+void CCommandLog::Append(const SCommand& command) {
+    if (!file) {
+        return;
+    }
+    uint32_t nameId = PutString(command.name);
+    uint32_t argumentId = PutString(command.argument);
+    int levelCode = (command.level >= -1 && command.level <= 1) ? command.level + 1 : LEVEL_ESCAPE;
+    pending += static_cast<char>(static_cast<int>(command.type) | (levelCode << LEVEL_SHIFT));
+    PutVarint(static_cast<uint64_t>(command.gate + 1));  // Unresolved names are stored as 0
+    PutVarint(ZigZag(command.value));
+    PutVarint(nameId);
+    PutVarint(argumentId);
+    if (levelCode == LEVEL_ESCAPE) {
+        PutVarint(ZigZag(command.level));
+    }
+    if (pending.size() >= LOG_BUFFER) {
+        failed |= std::fwrite(pending.data(), 1, pending.size(), file) != pending.size();
+        pending.clear();
+    }
+}
+
+// Writes what is left of a recorded log and closes it; returns false if any write failed
+bool CCommandLog::Close() {
+    if (!file) {
+        return true;
+    }
+    failed |= std::fwrite(pending.data(), 1, pending.size(), file) != pending.size();
+    failed |= std::fclose(file) != 0;
+    file = nullptr;
+    pending.clear();
+    if (failed) {
+        std::cerr << "Error: Cannot write command log " << logPath << std::endl;
+    }
+    return !failed;
+}
+
+// Reads a whole log into memory for replay; returns false if it is missing or not a log
+bool CCommandLog::Load(const std::string& path) {
+    CTraceSpan span("LoadCommandLog", "parse");
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        std::cerr << "Error: Cannot open command log " << path << std::endl;
+        return false;
+    }
+    std::ostringstream content;
+    content << in.rdbuf();
+    data = content.str();
+    logPath = path;
+    strings.clear();
+    uint32_t version = 0;
+    if (data.size() >= sizeof(LOG_MAGIC) + sizeof(version)) {
+        std::memcpy(&version, data.data() + sizeof(LOG_MAGIC), sizeof(version));
+    }
+    if (data.size() < sizeof(LOG_MAGIC) + sizeof(version)
+        || std::memcmp(data.data(), LOG_MAGIC, sizeof(LOG_MAGIC)) != 0 || version != LOG_VERSION) {
+        std::cerr << "Error: " << path << " is not a command log." << std::endl;
+        data.clear();
+        position = 0;
+        return false;
+    }
+    position = sizeof(LOG_MAGIC) + sizeof(version);
+    return true;
+}
+
+// Decodes the next command; returns false at the end of the log
+bool CCommandLog::Next(SCommand& command) {
+    while (position < data.size() && static_cast<unsigned char>(data[position]) == STRING_TAG) {
+        uint64_t length = 0;
+        ++position;
+        if (!GetVarint(length) || data.size() - position < length) {
+            std::cerr << "Error: Command log " << logPath << " is truncated." << std::endl;
+            position = data.size();
+            return false;
+        }
+        strings.emplace_back(data, position, length);
+        position += length;
+    }
+    if (position >= data.size()) {
+        return false;
+    }
+
+    int packed = static_cast<unsigned char>(data[position++]);
+    int levelCode = packed >> LEVEL_SHIFT;
+    uint64_t gate = 0, value = 0, level = 0;
+    command = SCommand();
+    command.type = static_cast<eCommand>(packed & ((1 << LEVEL_SHIFT) - 1));
+    bool complete = GetVarint(gate) && GetVarint(value) && GetString(command.name) && GetString(command.argument)
+                 && (levelCode != LEVEL_ESCAPE || GetVarint(level));
+    if (!complete || command.type > eCommand::COMMAND_END) {
+        std::cerr << "Error: Command log " << logPath << " is truncated." << std::endl;
+        position = data.size();
+        return false;
+    }
+    command.gate = static_cast<int>(gate) - 1;
+    command.value = UnZigZag(value);
+    command.level = (levelCode == LEVEL_ESCAPE) ? UnZigZag(level) : levelCode - 1;
+    return true;
+}
+
+// Encodes an unsigned integer seven bits per byte, low bits first
+void CCommandLog::PutVarint(uint64_t value) {
+    while (value >= 0x80) {
+        pending += static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    pending += static_cast<char>(value);
+}
+
+// Returns the id of a string, 0 for none, defining it in the log the first time it is seen
+uint32_t CCommandLog::PutString(const std::string* text) {
+    if (!text) {
+        return 0;
+    }
+    auto inserted = stringIds.emplace(*text, static_cast<uint32_t>(stringIds.size() + 1));
+    if (inserted.second) {
+        pending += static_cast<char>(STRING_TAG);
+        PutVarint(text->size());
+        pending += *text;
+    }
+    return inserted.first->second;
+}
+
+// Decodes a variable-length integer; returns false if the log ends inside it
+bool CCommandLog::GetVarint(uint64_t& value) {
+    value = 0;
+    for (int shift = 0; position < data.size() && shift < 64; shift += 7) {
+        unsigned char byte = static_cast<unsigned char>(data[position++]);
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Decodes a string id into the replayed string, nullptr for id 0; returns false for an undefined id
+bool CCommandLog::GetString(const std::string*& text) {
+    uint64_t id = 0;
+    if (!GetVarint(id) || id > strings.size()) {
+        return false;
+    }
+    text = (id > 0) ? &strings[id - 1] : nullptr;
+    return true;
+}
@@ -0,0 +1,41 @@
+#include "CDFlipFlop.h"
+
+// Constructor to initialize the flip-flop with an undefined D input
+CDFlipFlop::CDFlipFlop() {
+    SetInputCount(1);
+}
+
+// Stores the D input; Q only changes when the flip-flop is latched
+void CDFlipFlop::DriveInput(int inputIndex, eLogicLevel level) {
+    inputs[inputIndex] = level;
+}
+
+// Returns the current Q output of the flip-flop
+eLogicLevel CDFlipFlop::GetOutputState() const {
+    return outputValue;
+}
+
+// Returns a copy of the gate including its current input and output levels
+CLogicGates* CDFlipFlop::Clone() const {
+    return new CDFlipFlop(*this);
+}
+
+// Returns the bytes the gate occupies; its inputs are stored inline
+size_t CDFlipFlop::GetMemoryBytes() const {
+    return sizeof(*this) + GetInputHeapBytes();
+}
+
+// Flip-flops hold state across clock cycles
+bool CDFlipFlop::IsSequential() const {
+    return true;
+}
+
+// Captures D into Q on a clock edge
+void CDFlipFlop::Latch() {
+    ComputeOutput();
+}
+
+// Q takes the value of D
+void CDFlipFlop::ComputeOutput() {
+    outputValue = inputs[0];
+}
@@ -1,46 +1,626 @@
 #include "CFileReader.h"
-#include <iostream>
+#include "CCommandLog.h"
+#include "CSpscRing.h"
+#include "CTrace.h"
+#include "CVectorStimulus.h"
+#include <atomic>
+#include <cctype>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+static const size_t PIPELINE_BATCH = 1024;  // Commands per batch passed between pipeline stages
+static const size_t PIPELINE_SLOTS = 64;    // Batches buffered between two stages
+static const size_t RECORD_BUFFER = 1 << 16;  // Record bytes collected before they are written
+
+// Reads an optional count that follows a command on the same line
+static int ReadOptionalCount(std::istream& in, int defaultCount) {
+    while (in.peek() == ' ' || in.peek() == '\t') {
+        in.get();
+    }
+    int count = defaultCount;
+    if (std::isdigit(in.peek())) {
+        in >> count;
+    }
+    return count;
+}
+
+// Returns the statistics phase a command belongs to
+static ePhase PhaseOf(eCommand type) {
+    switch (type) {
+    case eCommand::COMMAND_COMPONENT:
+    case eCommand::COMMAND_REGISTER:
+    case eCommand::COMMAND_CONNECT:
+    case eCommand::COMMAND_TIE:
+    case eCommand::COMMAND_OBSERVE:
+    case eCommand::COMMAND_OPTIMIZE:
+    case eCommand::COMMAND_AIG:
+        return ePhase::PHASE_BUILD;
+    default:
+        return ePhase::PHASE_SIMULATE;
+    }
+}
+
+// Returns the trace span that groups consecutive commands of this kind
+static const char* BatchOf(eCommand type) {
+    switch (type) {
+    case eCommand::COMMAND_OPTIMIZE:
+        return "optimize";
+    case eCommand::COMMAND_AIG:
+        return "aig";
+    case eCommand::COMMAND_STIMULUS:
+    case eCommand::COMMAND_ACTIVITY:
+        return "vectors";
+    case eCommand::COMMAND_SAVE:
+    case eCommand::COMMAND_RESTORE:
+        return "checkpoint";
+    case eCommand::COMMAND_OUTPUT:
+    case eCommand::COMMAND_COMPARATOR_OUTPUT:
+    case eCommand::COMMAND_RECORD:
+        return "output";
+    default:
+        return (PhaseOf(type) == ePhase::PHASE_BUILD) ? "netlist" : "stimulus";
+    }
+}
 
 // Constructor that initializes the FileReader with a reference to the Circuit
-CFileReader::CFileReader(Circuit& circuit) : circuit(circuit) {}
+CFileReader::CFileReader(Circuit& circuit, std::istream& input, std::ostream& output, std::ostream& errors) 
+    : circuit(circuit), input(input), output(output), errors(errors) {
+    circuit.SetErrorStream(errors);  // The circuit reports to the same stream
+    ReloadGateTable();
+}
 
 // Processes input commands to build and simulate the circuit
 void CFileReader::ProcessInput() {
-    std::string Request; 
+    CSimStats& stats = circuit.GetStats();
+    CTrace& trace = CTrace::Instance();
+    CTraceSpan processSpan("ProcessInput", "parse");
+    SCommand command;
+    SResult result;
 
     // Loop to process each input command
-    while (std::cin >> Request) {
+    stats.SwitchPhase(ePhase::PHASE_PARSE);
+    while (NextCommand(command)) {
+        stats.SwitchPhase(PhaseOf(command.type));
+        trace.SwitchBatch(BatchOf(command.type));
+        if (command.type == eCommand::COMMAND_STIMULUS) {
+            FlushRecords();  // Vector records are written directly, after earlier output
+        }
+        ExecuteCommand(command, result);
+        stats.SwitchPhase(ePhase::PHASE_OUTPUT);
+        FormatResult(result);
+        stats.SwitchPhase(ePhase::PHASE_PARSE);  // Reading the next command counts as parsing
+        if (command.type == eCommand::COMMAND_END) {
+            trace.EndBatch();
+            break;  // Ends the simulator if end is received.
+        }
+    }
+    FlushRecords();
+    output.flush();
+}
+
+// Processes input commands with parsing on this thread, simulation and output
+// formatting on their own threads; batches pass through lock-free rings so the
+// output order is the command order
+void CFileReader::ProcessInputPipelined() {
+    CTrace& trace = CTrace::Instance();
+    CSpscRing<std::vector<SCommand>> commandRing(PIPELINE_SLOTS);
+    CSpscRing<std::vector<SResult>> resultRing(PIPELINE_SLOTS);
+    std::atomic<size_t> formattedBatches{0};
+    std::atomic<size_t> optimizedCount{0};
+
+    std::thread simulator([&] {
+        CTrace::Instance().NameThread("simulate");
+        std::vector<SCommand> commands;
+        std::vector<SResult> results;
+        size_t pushedBatches = 0;
+        bool running = true;
+        while (running) {
+            commandRing.Pop(commands);
+            CTraceSpan span("SimulateBatch", "simulate");
+            for (const SCommand& command : commands) {
+                if (command.type == eCommand::COMMAND_STIMULUS) {
+                    // Vector records are written directly, so wait until earlier output is out
+                    resultRing.Push(results);
+                    results.clear();
+                    ++pushedBatches;
+                    while (formattedBatches.load(std::memory_order_acquire) < pushedBatches) {
+                        std::this_thread::yield();
+                    }
+                }
+                results.emplace_back();
+                ExecuteCommand(command, results.back());
+                if (command.type == eCommand::COMMAND_OPTIMIZE) {
+                    optimizedCount.fetch_add(1, std::memory_order_release);
+                }
+                if (command.type == eCommand::COMMAND_END) {
+                    running = false;
+                    break;
+                }
+            }
+            resultRing.Push(results);
+            results.clear();
+            ++pushedBatches;
+        }
+    });
+
+    std::thread formatter([&] {
+        CTrace::Instance().NameThread("format");
+        std::vector<SResult> results;
+        bool running = true;
+        while (running) {
+            resultRing.Pop(results);
+            CTraceSpan span("FormatBatch", "output");
+            for (const SResult& result : results) {
+                FormatResult(result);
+                running &= (result.command.type != eCommand::COMMAND_END);
+            }
+            FlushRecords();
+            output.flush();
+            formattedBatches.fetch_add(1, std::memory_order_release);
+        }
+    });
+
+    std::vector<SCommand> batch;
+    SCommand command;
+    size_t optimizeIssued = 0;
+    double batchStart = 0.0;
+    while (true) {
+        if (batch.empty() && trace.IsEnabled()) {
+            batchStart = trace.Now();
+        }
+        if (!NextCommand(command)) {
+            command = SCommand();  // End of input acts as end
+        }
+        batch.push_back(command);
+
+        bool barrier = (command.type == eCommand::COMMAND_OPTIMIZE);
+        bool last = (command.type == eCommand::COMMAND_END);
+        bool waiting = !replayLog && input.rdbuf()->in_avail() <= 0;  // A replayed log is all in memory
+        if (barrier || last || batch.size() >= PIPELINE_BATCH || waiting) {
+            if (trace.IsEnabled()) {
+                trace.AddSpan("ParseBatch", "parse", batchStart, trace.Now());
+            }
+            commandRing.Push(batch);
+            batch.clear();
+        }
+        if (barrier) {
+            // Optimizing renumbers gates, so names can only be resolved again afterwards
+            ++optimizeIssued;
+            while (optimizedCount.load(std::memory_order_acquire) < optimizeIssued) {
+                std::this_thread::yield();
+            }
+        }
+        if (last) {
+            break;
+        }
+    }
+
+    simulator.join();
+    formatter.join();
+}
+
+// Takes the next command from the replayed log or the text input, recording it if asked
+bool CFileReader::NextCommand(SCommand& command) {
+    if (replayLog) {
+        return replayLog->Next(command);
+    }
+    if (!ParseCommand(command)) {
+        return false;
+    }
+    if (recordLog) {
+        recordLog->Append(command);
+    }
+    return true;
+}
+
+// Reads the next command, skipping comments and unknown words; returns false at end of input
+bool CFileReader::ParseCommand(SCommand& command) {
+    std::string Request; 
+    while (input >> Request) {
+        command = SCommand();
         if (Request[0] == '#') {
             std::string DummyVar;
-            std::getline(std::cin, DummyVar);  // Ignores comment lines
+            std::getline(input, DummyVar);  // Ignores comment lines
         } 
         else if (Request == "component") {
             std::string GateType, GateName;
-            std::cin >> GateType >> GateName;
-            circuit.AddGate(GateType, GateName);  // Adds a gate to the circuit
+            input >> GateType >> GateName;
+            command.type = eCommand::COMMAND_COMPONENT;
+            command.name = Intern(GateName);
+            command.argument = Intern(GateType);
+            if (GateType == "REG") {
+                command.type = eCommand::COMMAND_REGISTER;
+                command.value = ReadOptionalCount(input, 1);  // Register width
+                for (int bit = 0; bit < command.value; ++bit) {
+                    DeclareGate("DFF", GateName + "[" + std::to_string(bit) + "]", 0);
+                }
+            } else {
+                command.value = ReadOptionalCount(input, 0);  // Input count, 0 for the default
+                DeclareGate(GateType, GateName, command.value);
+            }
+            return true;
+        } 
+        else if (Request == "connect") {
+            std::string sourceName, targetName;
+            input >> sourceName >> targetName >> command.value;
+            command.type = eCommand::COMMAND_CONNECT;
+            command.name = Intern(sourceName);
+            command.argument = Intern(targetName);
+            return true;
+        } 
+        else if (Request == "clock") {
+            input >> command.value;
+            command.type = eCommand::COMMAND_CLOCK;
+            return true;
         } 
-        else if (Request == "input") {
+        else if (Request == "input" || Request == "tie") {
             std::string gateName;
-            int inputIndex, level;
-            std::cin >> gateName >> inputIndex >> level;
-            circuit.DriveGate(gateName, inputIndex, static_cast<eLogicLevel>(level));  // Drive input to the gate
-
+            input >> gateName >> command.value >> command.level;
+            command.type = (Request == "input") ? eCommand::COMMAND_INPUT : eCommand::COMMAND_TIE;
+            command.name = Intern(gateName);
+            command.gate = ResolveGate(gateName);
+            return true;
+        } 
+        else if (Request == "observe") {
+            std::string gateName;
+            input >> gateName;
+            command.type = eCommand::COMMAND_OBSERVE;
+            command.name = Intern(gateName);
+            return true;
+        } 
+        else if (Request == "optimize") {
+            command.type = eCommand::COMMAND_OPTIMIZE;
+            return true;
+        } 
+        else if (Request == "aig") {
+            command.type = eCommand::COMMAND_AIG;
+            return true;
+        } 
+        else if (Request == "snapshot") {
+            std::string snapshotName;
+            input >> snapshotName;
+            command.type = eCommand::COMMAND_SNAPSHOT;
+            command.argument = Intern(snapshotName);
+            return true;
+        } 
+        else if (Request == "compare" || Request == "diff") {
+            std::string leftName, rightName;
+            input >> leftName >> rightName;
+            command.type = (Request == "compare") ? eCommand::COMMAND_COMPARE : eCommand::COMMAND_DIFF;
+            command.name = Intern(leftName);
+            command.argument = Intern(rightName);
+            return true;
+        } 
+        else if (Request == "memory") {
+            command.type = eCommand::COMMAND_MEMORY;
+            return true;
+        } 
+        else if (Request == "stimulus" || Request == "activity" || Request == "lazy" 
+                 || Request == "prune" || Request == "save" || Request == "restore") {
+            std::string argument;
+            input >> argument;
+            command.type = (Request == "stimulus") ? eCommand::COMMAND_STIMULUS 
+                         : (Request == "activity") ? eCommand::COMMAND_ACTIVITY 
+                         : (Request == "lazy") ? eCommand::COMMAND_LAZY 
+                         : (Request == "prune") ? eCommand::COMMAND_PRUNE 
+                         : (Request == "save") ? eCommand::COMMAND_SAVE : eCommand::COMMAND_RESTORE;
+            command.argument = Intern(argument);
+            return true;
         } 
         else if (Request == "output") {
             std::string gateName;
-            std::cin >> gateName;
-            // Output the result of the specified gate
-            std::cout << "Gate " << gateName << " output: " << static_cast<int>(circuit.GetGateOutput(gateName)) << std::endl;
+            input >> gateName;
+            command.type = eCommand::COMMAND_OUTPUT;
+            command.name = Intern(gateName);
+            command.gate = ResolveGate(gateName);
+            return true;
         } 
         else if (Request == "comparator_output") {
             std::string gateName, outputType;
-            std::cin >> gateName >> outputType;
-            // Output the result of the comparator based on the comparison type
-            eLogicLevel result = circuit.GetComparatorOutput(gateName, outputType);
-            std::cout << gateName << " " << outputType << " output: " << static_cast<int>(result) << std::endl;
+            input >> gateName >> outputType;
+            command.type = eCommand::COMMAND_COMPARATOR_OUTPUT;
+            command.name = Intern(gateName);
+            command.argument = Intern(outputType);
+            command.gate = ResolveGate(gateName);
+            return true;
+        } 
+        else if (Request == "record") {
+            command.type = eCommand::COMMAND_RECORD;
+            return true;
         } 
         else if (Request == "end") {
-            break;  // Ends the simulator if end is received.
+            command.type = eCommand::COMMAND_END;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Runs one command on the circuit and records what needs to be printed
+void CFileReader::ExecuteCommand(const SCommand& command, SResult& result) {
+    result.command = command;
+    result.ok = true;
+    result.value = 0;
+    result.text.clear();
+    eLogicLevel level = static_cast<eLogicLevel>(command.level);
+
+    switch (command.type) {
+    case eCommand::COMMAND_COMPONENT:
+        circuit.AddGate(*command.argument, *command.name, command.value);  // Adds a gate to the circuit
+        break;
+    case eCommand::COMMAND_REGISTER:
+        circuit.AddRegister(*command.name, command.value);  // Adds a bank of flip-flops
+        break;
+    case eCommand::COMMAND_CONNECT:
+        circuit.ConnectGates(*command.name, *command.argument, command.value);  // Wires a gate output to a gate input
+        break;
+    case eCommand::COMMAND_TIE:
+        circuit.TieInput(*command.name, command.value, level);  // Ties an input to 0 or 1
+        break;
+    case eCommand::COMMAND_OBSERVE:
+        circuit.AddOutputGate(*command.name);  // Marks a gate whose output is observed
+        break;
+    case eCommand::COMMAND_OPTIMIZE:
+        result.value = circuit.Optimize();  // Simplifies the netlist before simulation
+        ReloadGateTable();
+        recordGates.clear();
+        break;
+    case eCommand::COMMAND_AIG: {
+        CAig aig;
+        SAigMapping mapping;
+        result.ok = circuit.BuildAig(aig, mapping);  // Lowers the circuit into an AND-inverter graph
+        result.text = "AIG: " + std::to_string(aig.GetInputCount()) + " inputs, " 
+                    + std::to_string(aig.GetAndCount()) + " AND nodes, " 
+                    + std::to_string(aig.GetMemoryBytes()) + " bytes";
+        break;
+    }
+    case eCommand::COMMAND_STIMULUS: {
+        CVectorStimulus vectorStimulus(circuit);
+        result.ok = vectorStimulus.Run(*command.argument, output);  // Streams a vector file through the bit-parallel engine
+        break;
+    }
+    case eCommand::COMMAND_ACTIVITY: {
+        std::ostringstream report;
+        CVectorStimulus vectorStimulus(circuit);
+        result.ok = vectorStimulus.RunActivity(*command.argument, report);  // Counts output toggles bit-parallel
+        result.text = report.str();
+        break;
+    }
+    case eCommand::COMMAND_LAZY:
+        circuit.SetLazyEvaluation(*command.argument == "on");  // Evaluates only when outputs are queried
+        break;
+    case eCommand::COMMAND_PRUNE:
+        result.value = circuit.SetConePruning(*command.argument == "on");  // Simulates only the observed cone
+        break;
+    case eCommand::COMMAND_SAVE:
+        result.ok = circuit.SaveCheckpoint(*command.argument);  // Dumps every gate level to a binary image
+        break;
+    case eCommand::COMMAND_RESTORE:
+        result.ok = circuit.RestoreCheckpoint(*command.argument);  // Resumes from a saved image
+        break;
+    case eCommand::COMMAND_CLOCK:
+        circuit.Clock(command.value);  // Runs the clocked simulation for the requested cycles
+        break;
+    case eCommand::COMMAND_INPUT:
+        result.ok = (command.gate >= 0) ? circuit.DriveGate(command.gate, command.value, level) 
+                                        : circuit.DriveGate(*command.name, command.value, level);  // Drive input to the gate
+        break;
+    case eCommand::COMMAND_OUTPUT:
+        result.value = static_cast<int>((command.gate >= 0) ? circuit.GetGateOutput(command.gate) 
+                                                            : circuit.GetGateOutput(*command.name));
+        break;
+    case eCommand::COMMAND_COMPARATOR_OUTPUT:
+        result.value = static_cast<int>((command.gate >= 0) 
+            ? circuit.GetComparatorOutput(command.gate, *command.argument) 
+            : circuit.GetComparatorOutput(*command.name, *command.argument));
+        break;
+    case eCommand::COMMAND_MEMORY: {
+        std::ostringstream report;
+        circuit.WriteMemoryReport(report);  // Bytes held by gates and netlist
+        result.text = report.str();
+        break;
+    }
+    case eCommand::COMMAND_SNAPSHOT:
+        circuit.Settle();
+        snapshots[*command.argument].Capture(circuit);  // Packs every net level, 2 bits each
+        break;
+    case eCommand::COMMAND_COMPARE:
+    case eCommand::COMMAND_DIFF:
+        CompareSnapshots(command, result);
+        break;
+    case eCommand::COMMAND_RECORD:
+        SampleRecord(result);  // One packed row over every observed gate
+        break;
+    case eCommand::COMMAND_END:
+        break;
+    }
+}
+
+// Prints the result of a command in the simulator's text format
+void CFileReader::FormatResult(const SResult& result) {
+    const SCommand& command = result.command;
+    if (command.type == eCommand::COMMAND_RECORD) {
+        records += result.text;  // Records are collected and written in large blocks
+        if (records.size() >= RECORD_BUFFER) {
+            FlushRecords();
+        }
+        return;
+    }
+    FlushRecords();  // Keeps records in order with the other output
+    switch (command.type) {
+    case eCommand::COMMAND_INPUT:
+        if (result.ok) {
+            output << "Input Index " << command.value 
+            << " of " << *command.name << " gate runs with logic " 
+                   << command.level << '\n';  // Output driven input
+        }
+        break;
+    case eCommand::COMMAND_OPTIMIZE:
+        output << "Optimization removed " << result.value << " gates\n";
+        break;
+    case eCommand::COMMAND_PRUNE:
+        if (*command.argument == "on") {
+            output << "Cone of influence keeps " << result.value << " gates\n";
         }
+        break;
+    case eCommand::COMMAND_MEMORY:
+        output << result.text << '\n';
+        break;
+    case eCommand::COMMAND_AIG:
+    case eCommand::COMMAND_ACTIVITY:
+        if (result.ok) {
+            output << result.text << '\n';
+        }
+        break;
+    case eCommand::COMMAND_COMPARE:
+    case eCommand::COMMAND_DIFF:
+        output << result.text;
+        break;
+    case eCommand::COMMAND_OUTPUT:
+        // Output the result of the specified gate
+        output << "Gate " << *command.name << " output: " << result.value << '\n';
+        break;
+    case eCommand::COMMAND_COMPARATOR_OUTPUT:
+        // Output the result of the comparator based on the comparison type
+        output << *command.name << " " << *command.argument << " output: " << result.value << '\n';
+        break;
+    default:
+        break;
+    }
+}
+
+// Returns a named snapshot, or the present state captured into current for the name "current"
+const CPackedState* CFileReader::FindSnapshot(const std::string& snapshotName, CPackedState& current) {
+    if (snapshotName == "current") {
+        circuit.Settle();
+        current.Capture(circuit);
+        return &current;
+    }
+    auto it = snapshots.find(snapshotName);
+    if (it == snapshots.end()) {
+        errors << "Error: Snapshot " << snapshotName << " not found." << std::endl;
+        return nullptr;
+    }
+    return &it->second;
+}
+
+// Counts the nets that differ between two snapshots and, for diff, lists them
+void CFileReader::CompareSnapshots(const SCommand& command, SResult& result) {
+    CPackedState leftCurrent, rightCurrent;
+    const CPackedState* left = FindSnapshot(*command.name, leftCurrent);
+    const CPackedState* right = FindSnapshot(*command.argument, rightCurrent);
+    if (!left || !right) {
+        result.ok = false;
+        return;
+    }
+    if (left->GetNetCount() != right->GetNetCount()) {
+        errors << "Error: Snapshots " << *command.name << " and " 
+        << *command.argument << " cover different netlists." << std::endl;
+        result.ok = false;
+        return;
+    }
+
+    std::ostringstream text;
+    size_t differences = 0;
+    if (!left->Equals(*right) && command.type == eCommand::COMMAND_DIFF) {
+        std::vector<size_t> nets;
+        left->Diff(*right, nets);
+        differences = nets.size();
+        int gateId = 0;
+        size_t firstNet = 0;  // First net of gateId; nets are listed in gate order
+        for (size_t net : nets) {
+            while (firstNet + circuit.GetGate(gateId)->GetStateCount() <= net) {
+                firstNet += circuit.GetGate(gateId++)->GetStateCount();
+            }
+            text << "Net " << circuit.GetGateName(gateId);
+            if (circuit.GetGate(gateId)->GetStateCount() > 1) {
+                text << ":" << net - firstNet;  // Comparator output 0 greater, 1 equal, 2 less
+            }
+            text << " " << static_cast<int>(left->Get(net)) << " -> " << static_cast<int>(right->Get(net)) << '\n';
+        }
+    } else if (!left->Equals(*right)) {
+        differences = left->CountDifferences(*right);
+    }
+    text << "Snapshots " << *command.name << " and " << *command.argument 
+         << " differ in " << differences << " nets\n";
+    result.text = text.str();
+}
+
+// Returns a stable pointer to a shared copy of the text
+const std::string* CFileReader::Intern(const std::string& text) {
+    return &*strings.insert(text).first;
+}
+
+// Returns the gate index a name will have when its command runs, or -1
+int CFileReader::ResolveGate(const std::string& gateName) const {
+    auto it = gateIds.find(gateName);
+    return (it != gateIds.end()) ? it->second : -1;
+}
+
+// Records the index the circuit will give a gate declared by a component command
+void CFileReader::DeclareGate(const std::string& gateType, const std::string& gateName, int inputCount) {
+    if (Circuit::IsKnownGateType(gateType, inputCount) && gateIds.emplace(gateName, gateCount).second) {
+        ++gateCount;
+    }
+}
+
+// Reads the gate indices back from the circuit, e.g. after optimization renumbered them
+void CFileReader::ReloadGateTable() {
+    gateIds.clear();
+    gateCount = circuit.GetGateCount();
+    for (int gateId = 0; gateId < gateCount; ++gateId) {
+        gateIds[circuit.GetGateName(gateId)] = gateId;
+    }
+}
+
+// Samples every observed gate into one record: a character per output, 0, 1 or
+// X for undefined, comparators giving greater, equal and less. A header naming
+// the columns comes first and again whenever another gate is observed.
+void CFileReader::SampleRecord(SResult& result) {
+    static const char* comparatorOutputs[] = {"greater", "equal", "less"};
+    static const char levelCharacters[] = {'X', '0', '1'};
+    const std::vector<std::string>& outputGates = circuit.GetOutputGates();
+    if (recordGates.size() != outputGates.size()) {
+        recordGates.clear();
+        for (const std::string& gateName : outputGates) {
+            recordGates.push_back(circuit.FindGate(gateName));
+        }
+    }
+    if (headerOutputs != outputGates.size()) {
+        result.text = "outputs";
+        for (size_t output = 0; output < outputGates.size(); ++output) {
+            const CLogicGates* gate = (recordGates[output] >= 0) ? circuit.GetGate(recordGates[output]) : nullptr;
+            if (gate && gate->GetStateCount() == 3) {
+                for (const char* outputType : comparatorOutputs) {
+                    result.text += " " + outputGates[output] + "." + outputType;
+                }
+            } else {
+                result.text += " " + outputGates[output];
+            }
+        }
+        result.text += '\n';
+        headerOutputs = outputGates.size();
+    }
+
+    for (int gateId : recordGates) {
+        if (gateId < 0) {
+            result.text += 'X';
+        } else if (circuit.GetGate(gateId)->GetStateCount() == 3) {
+            for (const char* outputType : comparatorOutputs) {
+                result.text += levelCharacters[static_cast<int>(circuit.GetComparatorOutput(gateId, outputType)) + 1];
+            }
+        } else {
+            result.text += levelCharacters[static_cast<int>(circuit.GetGateOutput(gateId)) + 1];
+        }
+    }
+    result.text += '\n';
+}
+
+// Writes the collected records to the output
+void CFileReader::FlushRecords() {
+    if (!records.empty()) {
+        output.write(records.data(), records.size());
+        records.clear();
     }
 }
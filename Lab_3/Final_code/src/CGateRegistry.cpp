@@ -0,0 +1,127 @@
+#include "CGateRegistry.h"
+#include "CAig.h"
+#include "CAndGate.h"
+#include "COrGate.h"
+#include "CXORGate.h"
+#include "CNOTGate.h"
+#include "COneBitComparator.h"
+#include "CDFlipFlop.h"
+#include "CKernelGate.h"
+
+// Passes the input through unchanged
+static eLogicLevel BufferKernel(const eLogicLevel* inputs, int inputCount) {
+    return inputs[0];
+}
+
+// Selects input 0 when input 2 is low and input 1 when it is high; an undefined
+// select still gives a level when both data inputs agree
+static eLogicLevel MuxKernel(const eLogicLevel* inputs, int inputCount) {
+    if (inputs[2] == eLogicLevel::LOGIC_UNDEFINED) {
+        return (inputs[0] == inputs[1]) ? inputs[0] : eLogicLevel::LOGIC_UNDEFINED;
+    }
+    return inputs[(inputs[2] == eLogicLevel::LOGIC_HIGH) ? 1 : 0];
+}
+
+// Drives input 0 while input 1 enables the buffer; a released output floats,
+// which reads as undefined
+static eLogicLevel TriStateKernel(const eLogicLevel* inputs, int inputCount) {
+    return (inputs[1] == eLogicLevel::LOGIC_HIGH) ? inputs[0] : eLogicLevel::LOGIC_UNDEFINED;
+}
+
+// A buffer is the literal of its input
+static uint32_t LowerBuffer(CAig& aig, const std::vector<uint32_t>& inputLiterals) {
+    return inputLiterals[0];
+}
+
+// A multiplexer is (a AND NOT s) OR (b AND s)
+static uint32_t LowerMux(CAig& aig, const std::vector<uint32_t>& inputLiterals) {
+    return aig.AddOr(aig.AddAnd(inputLiterals[0], CAig::Not(inputLiterals[2])), 
+                     aig.AddAnd(inputLiterals[1], inputLiterals[2]));
+}
+
+// The AIG is two-valued, so a floating tri-state output is lowered as low
+static uint32_t LowerTriState(CAig& aig, const std::vector<uint32_t>& inputLiterals) {
+    return aig.AddAnd(inputLiterals[0], inputLiterals[1]);
+}
+
+// Returns the registry shared by every circuit
+CGateRegistry& CGateRegistry::Instance() {
+    static CGateRegistry registry;
+    return registry;
+}
+
+// Constructor that registers the built-in gate kinds
+CGateRegistry::CGateRegistry() {
+    const SGateType builtins[] = {
+        {"AND",  [](int inputCount) -> CLogicGates* { return new CAndGates(inputCount); }, 
+         nullptr, nullptr, 2, 2, MAX_GATE_INPUTS},
+        {"OR",   [](int inputCount) -> CLogicGates* { return new COrGates(inputCount); }, 
+         nullptr, nullptr, 2, 2, MAX_GATE_INPUTS},
+        {"XOR",  [](int inputCount) -> CLogicGates* { return new CXORGates(inputCount); }, 
+         nullptr, nullptr, 2, 2, MAX_GATE_INPUTS},
+        {"NAND", [](int inputCount) -> CLogicGates* { return new CAndGates(inputCount, true); }, 
+         nullptr, nullptr, 2, 2, MAX_GATE_INPUTS},
+        {"NOR",  [](int inputCount) -> CLogicGates* { return new COrGates(inputCount, true); }, 
+         nullptr, nullptr, 2, 2, MAX_GATE_INPUTS},
+        {"XNOR", [](int inputCount) -> CLogicGates* { return new CXORGates(inputCount, true); }, 
+         nullptr, nullptr, 2, 2, MAX_GATE_INPUTS},
+        {"NOT",  [](int inputCount) -> CLogicGates* { return new CNotGate(); }, 
+         nullptr, nullptr, 1, 1, 1},
+        {"1BitComparator", [](int inputCount) -> CLogicGates* { return new COneBitComparator(); }, 
+         nullptr, nullptr, 2, 2, 2},
+        {"DFF",  [](int inputCount) -> CLogicGates* { return new CDFlipFlop(); }, 
+         nullptr, nullptr, 1, 1, 1},
+        {"BUF",  nullptr, BufferKernel, LowerBuffer, 1, 1, 1},
+        {"MUX",  nullptr, MuxKernel, LowerMux, 3, 3, 3},
+        {"TRI",  nullptr, TriStateKernel, LowerTriState, 2, 2, 2},
+    };
+    for (const SGateType& type : builtins) {
+        Register(type);
+    }
+}
+
+// Adds a gate kind and returns its type id; a name that is already registered
+// keeps its id and gets the new description
+int CGateRegistry::Register(const SGateType& type) {
+    auto found = typeIds.find(type.name);
+    if (found != typeIds.end()) {
+        types[found->second] = type;
+        return found->second;
+    }
+    int typeId = static_cast<int>(types.size());
+    typeIds.emplace(type.name, typeId);
+    types.push_back(type);
+    return typeId;
+}
+
+// Returns the type id of a gate kind, or -1 if it is not registered
+int CGateRegistry::FindType(const std::string& name) const {
+    auto found = typeIds.find(name);
+    return (found != typeIds.end()) ? found->second : -1;
+}
+
+// Returns true if the gate kind can be built with the given input count; 0 means its default
+bool CGateRegistry::AcceptsInputCount(int typeId, int inputCount) const {
+    const SGateType& type = types[typeId];
+    return inputCount == 0 || (inputCount >= type.minInputs && inputCount <= type.maxInputs);
+}
+
+// Builds a gate of the given kind; 0 inputs means the kind's default
+CLogicGates* CGateRegistry::Create(int typeId, int inputCount) const {
+    const SGateType& type = types[typeId];
+    int width = (inputCount > 0) ? inputCount : type.defaultInputs;
+    if (type.factory) {
+        return type.factory(width);
+    }
+    return new CKernelGate(type.kernel, type.lowering, width);
+}
+
+// Returns the name a gate kind was registered under
+const std::string& CGateRegistry::GetName(int typeId) const {
+    return types[typeId].name;
+}
+
+// Returns the number of registered gate kinds
+int CGateRegistry::GetTypeCount() const {
+    return static_cast<int>(types.size());
+}
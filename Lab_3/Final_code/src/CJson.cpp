@@ -0,0 +1,19 @@
+#include "CJson.h"
+#include <cstdio>
+
+// Writes text as a JSON string, escaping quotes, backslashes and control characters
+void CJson::WriteString(std::ostream& out, const std::string& text) {
+    out << '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out << escaped;
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
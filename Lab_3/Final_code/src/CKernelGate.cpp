@@ -0,0 +1,40 @@
+#include "CKernelGate.h"
+#include "CAig.h"
+
+// Constructor to initialize a kernel gate with undefined inputs
+CKernelGate::CKernelGate(GateKernel kernel, GateLowering lowering, int inputCount) 
+    : kernel(kernel), lowering(lowering) {
+    SetInputCount(inputCount);
+}
+
+// Sets the logic level of a specific input and recomputes the output
+void CKernelGate::DriveInput(int inputIndex, eLogicLevel level) {
+    inputs[inputIndex] = level;
+    ComputeOutput();
+}
+
+// Returns the current output state of the gate
+eLogicLevel CKernelGate::GetOutputState() const {
+    return outputValue;
+}
+
+// Returns a copy of the gate including its current input and output levels
+CLogicGates* CKernelGate::Clone() const {
+    return new CKernelGate(*this);
+}
+
+// Returns the bytes the gate occupies including any heap block for wide inputs
+size_t CKernelGate::GetMemoryBytes() const {
+    return sizeof(*this) + GetInputHeapBytes();
+}
+
+// Computes the output by running the registered kernel over the input span
+void CKernelGate::ComputeOutput() {
+    outputValue = kernel(inputs, inputCount);
+}
+
+// Lowers the gate into the AND-inverter graph with the registered lowering
+void CKernelGate::LowerToAig(CAig& aig, const std::vector<uint32_t>& inputLiterals,
+                             std::vector<uint32_t>& outputLiterals) const {
+    outputLiterals.assign(1, lowering(aig, inputLiterals));
+}
@@ -0,0 +1,25 @@
+#include "CLogicGates.h"
+#include <algorithm>
+
+// Copy constructor that gives the copy its own input storage
+CLogicGates::CLogicGates(const CLogicGates& other) : outputValue(other.outputValue), evaluated(other.evaluated) {
+    SetInputCount(other.inputCount);
+    std::copy(other.inputs, other.inputs + other.inputCount, inputs);
+}
+
+// Destructor that frees the inputs of a wide gate
+CLogicGates::~CLogicGates() {
+    if (inputs != inlineInputs) {
+        delete[] inputs;
+    }
+}
+
+// Sets the number of inputs, all undefined; more than INLINE_GATE_INPUTS go on the heap
+void CLogicGates::SetInputCount(int count) {
+    if (inputs != inlineInputs) {
+        delete[] inputs;
+    }
+    inputs = (count > INLINE_GATE_INPUTS) ? new eLogicLevel[count] : inlineInputs;
+    inputCount = static_cast<uint16_t>(count);
+    std::fill(inputs, inputs + count, eLogicLevel::LOGIC_UNDEFINED);
+}
@@ -1,8 +1,9 @@
 #include "CNOTGate.h"
+#include "CAig.h"
 
 // Constructor to initialize NOT gate with one undefined input
 CNotGate::CNotGate() {
-    inputs.resize(1, eLogicLevel::LOGIC_UNDEFINED);
+    SetInputCount(1);
 }
 
 // Sets the logic level of the input and recomputes the output
@@ -16,7 +17,23 @@ eLogicLevel CNotGate::GetOutputState() const {
     return outputValue;
 }
 
+// Returns a copy of the gate including its current input and output levels
+CLogicGates* CNotGate::Clone() const {
+    return new CNotGate(*this);
+}
+
+// Returns the bytes the gate occupies; its inputs are stored inline
+size_t CNotGate::GetMemoryBytes() const {
+    return sizeof(*this) + GetInputHeapBytes();
+}
+
 // Computes the NOT gate's output based on its single input (inverts the input)
 void CNotGate::ComputeOutput() {
     outputValue = (inputs[0] == eLogicLevel::LOGIC_HIGH) ? eLogicLevel::LOGIC_LOW : eLogicLevel::LOGIC_HIGH;
 }
+
+// Lowers the NOT gate into the AND-inverter graph
+void CNotGate::LowerToAig(CAig& aig, const std::vector<uint32_t>& inputLiterals,
+                          std::vector<uint32_t>& outputLiterals) const {
+    outputLiterals.assign(1, CAig::Not(inputLiterals[0]));
+}
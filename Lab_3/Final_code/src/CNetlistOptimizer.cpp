@@ -0,0 +1,300 @@
+#include "CNetlistOptimizer.h"
+#include "CVcdWriter.h"
+#include <algorithm>
+#include <unordered_map>
+
+// Constructor that records the fan-in of every gate and which gates are observed.
+// Without declared output gates, every gate with no fan-out counts as observed.
+CNetlistOptimizer::CNetlistOptimizer(Circuit& circuit) : circuit(circuit) {
+    size_t gateCount = circuit.gates.size();
+    fanins.resize(gateCount);
+    for (size_t gateId = 0; gateId < gateCount; ++gateId) {
+        fanins[gateId].assign(circuit.gates[gateId]->GetInputCount(), -1);
+    }
+    for (size_t source = 0; source < gateCount; ++source) {
+        for (const Circuit::SConnection& connection : circuit.fanouts[source]) {
+            fanins[connection.gate][connection.inputIndex] = static_cast<int>(source);
+        }
+    }
+
+    removed.assign(gateCount, false);
+    observed.assign(gateCount, circuit.outputGates.empty());
+    if (circuit.outputGates.empty()) {
+        for (size_t gateId = 0; gateId < gateCount; ++gateId) {
+            observed[gateId] = circuit.fanouts[gateId].empty();
+        }
+    } else {
+        for (const std::string& gateName : circuit.outputGates) {
+            int gateId = circuit.FindGate(gateName);
+            if (gateId >= 0) {
+                observed[gateId] = true;
+            }
+        }
+    }
+}
+
+// Runs every simplification until none applies, then drops the removed gates
+int CNetlistOptimizer::Run() {
+    bool changed = true;
+    while (changed) {
+        changed = PropagateConstants();
+        changed |= BypassBuffers();
+        changed |= CollapseDoubleInversions();
+        changed |= MergeDuplicates();
+        changed |= RemoveDeadGates();
+    }
+    return Compact();
+}
+
+// Only single-output combinational gates are rewritten
+bool CNetlistOptimizer::IsSimpleGate(int gateId) const {
+    const std::string& type = circuit.GetGateType(gateId);
+    return !removed[gateId] && (type == "AND" || type == "OR" || type == "XOR" || type == "NOT");
+}
+
+// True when every input is fed by a gate or tied, so stimulus cannot reach the gate
+bool CNetlistOptimizer::IsFullyConnected(int gateId) const {
+    for (size_t input = 0; input < fanins[gateId].size(); ++input) {
+        if (fanins[gateId][input] < 0 && circuit.tiedInputs[gateId][input] == eLogicLevel::LOGIC_UNDEFINED) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Returns the level a gate is forced to by its tied inputs, or undefined if it still varies
+eLogicLevel CNetlistOptimizer::ConstantOutput(int gateId) const {
+    const std::string& type = circuit.GetGateType(gateId);
+    size_t tiedCount = 0;
+    bool anyLow = false, anyHigh = false;
+    for (size_t input = 0; input < fanins[gateId].size(); ++input) {
+        eLogicLevel tied = circuit.tiedInputs[gateId][input];
+        if (fanins[gateId][input] < 0 && tied != eLogicLevel::LOGIC_UNDEFINED) {
+            ++tiedCount;
+            anyLow |= (tied == eLogicLevel::LOGIC_LOW);
+            anyHigh |= (tied == eLogicLevel::LOGIC_HIGH);
+        }
+    }
+
+    if (tiedCount == fanins[gateId].size()) {
+        return circuit.gates[gateId]->GetOutputState();  // Tied inputs were already driven
+    } else if (type == "AND" && anyLow) {
+        return eLogicLevel::LOGIC_LOW;
+    } else if (type == "OR" && anyHigh) {
+        return eLogicLevel::LOGIC_HIGH;
+    }
+    return eLogicLevel::LOGIC_UNDEFINED;
+}
+
+// Builds a key that is equal for gates of the same type with the same inputs
+std::string CNetlistOptimizer::StructuralKey(int gateId) const {
+    std::vector<std::string> operands;
+    for (size_t input = 0; input < fanins[gateId].size(); ++input) {
+        if (fanins[gateId][input] >= 0) {
+            operands.push_back("g" + std::to_string(fanins[gateId][input]));
+        } else {
+            operands.push_back("c" + std::to_string(static_cast<int>(circuit.tiedInputs[gateId][input])));
+        }
+    }
+    std::sort(operands.begin(), operands.end());  // AND, OR and XOR are commutative
+
+    std::string key = circuit.GetGateType(gateId);
+    for (const std::string& operand : operands) {
+        key += " " + operand;
+    }
+    return key;
+}
+
+// Replaces gates whose output is fixed by tied inputs with constants on their fan-out
+bool CNetlistOptimizer::PropagateConstants() {
+    bool changed = false;
+    for (size_t gateId = 0; gateId < fanins.size(); ++gateId) {
+        if (IsSimpleGate(gateId) && !circuit.fanouts[gateId].empty()) {
+            eLogicLevel level = ConstantOutput(gateId);
+            if (level != eLogicLevel::LOGIC_UNDEFINED) {
+                TieFanout(gateId, level);
+                changed = true;
+            }
+        }
+    }
+    return changed;
+}
+
+// Skips AND gates tied to 1 and OR/XOR gates tied to 0, which just pass their other input
+bool CNetlistOptimizer::BypassBuffers() {
+    bool changed = false;
+    for (size_t gateId = 0; gateId < fanins.size(); ++gateId) {
+        const std::string& type = circuit.GetGateType(gateId);
+        if (!IsSimpleGate(gateId) || type == "NOT" || circuit.fanouts[gateId].empty()
+            || fanins[gateId].size() != 2 || !IsFullyConnected(gateId)) {
+            continue;
+        }
+
+        eLogicLevel identity = (type == "AND") ? eLogicLevel::LOGIC_HIGH : eLogicLevel::LOGIC_LOW;
+        for (int input = 0; input < 2; ++input) {
+            int other = fanins[gateId][1 - input];
+            if (fanins[gateId][input] < 0 && circuit.tiedInputs[gateId][input] == identity && other >= 0) {
+                Redirect(gateId, other);
+                changed = true;
+                break;
+            }
+        }
+    }
+    return changed;
+}
+
+// Connects the fan-out of NOT(NOT(x)) straight to x
+bool CNetlistOptimizer::CollapseDoubleInversions() {
+    bool changed = false;
+    for (size_t gateId = 0; gateId < fanins.size(); ++gateId) {
+        if (!IsSimpleGate(gateId) || circuit.GetGateType(gateId) != "NOT" || circuit.fanouts[gateId].empty()) {
+            continue;
+        }
+        int inner = fanins[gateId][0];
+        if (inner >= 0 && IsSimpleGate(inner) && circuit.GetGateType(inner) == "NOT" && fanins[inner][0] >= 0) {
+            Redirect(gateId, fanins[inner][0]);
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+// Moves the fan-out of structurally identical gates onto the first of them
+bool CNetlistOptimizer::MergeDuplicates() {
+    bool changed = false;
+    std::unordered_map<std::string, int> firstGate;
+    for (size_t gateId = 0; gateId < fanins.size(); ++gateId) {
+        if (!IsSimpleGate(gateId) || !IsFullyConnected(gateId)) {
+            continue;
+        }
+        auto inserted = firstGate.emplace(StructuralKey(gateId), static_cast<int>(gateId));
+        if (!inserted.second && !circuit.fanouts[gateId].empty()) {
+            Redirect(gateId, inserted.first->second);
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+// Removes unobserved gates with no fan-out, repeating as their drivers lose fan-out too
+bool CNetlistOptimizer::RemoveDeadGates() {
+    bool changed = false;
+    std::vector<int> pending;
+    for (size_t gateId = 0; gateId < fanins.size(); ++gateId) {
+        pending.push_back(static_cast<int>(gateId));
+    }
+
+    while (!pending.empty()) {
+        int gateId = pending.back();
+        pending.pop_back();
+        if (removed[gateId] || observed[gateId] || !circuit.fanouts[gateId].empty()) {
+            continue;
+        }
+
+        removed[gateId] = true;
+        changed = true;
+        for (size_t input = 0; input < fanins[gateId].size(); ++input) {
+            int source = fanins[gateId][input];
+            if (source < 0) {
+                continue;
+            }
+            std::vector<Circuit::SConnection>& sourceFanout = circuit.fanouts[source];
+            sourceFanout.erase(std::remove_if(sourceFanout.begin(), sourceFanout.end(),
+                [&](const Circuit::SConnection& connection) {
+                    return connection.gate == gateId && connection.inputIndex == static_cast<int>(input);
+                }), sourceFanout.end());
+            pending.push_back(source);
+        }
+    }
+    return changed;
+}
+
+// Ties every input fed by a gate to a constant and disconnects the gate
+void CNetlistOptimizer::TieFanout(int gateId, eLogicLevel level) {
+    std::vector<Circuit::SConnection> fanout;
+    fanout.swap(circuit.fanouts[gateId]);
+    for (const Circuit::SConnection& connection : fanout) {
+        fanins[connection.gate][connection.inputIndex] = -1;
+        circuit.tiedInputs[connection.gate][connection.inputIndex] = level;
+        DriveConnection(connection.gate, connection.inputIndex, level);
+    }
+}
+
+// Moves the fan-out of a gate onto another gate with the same logic value
+void CNetlistOptimizer::Redirect(int gateId, int sourceId) {
+    std::vector<Circuit::SConnection> fanout;
+    fanout.swap(circuit.fanouts[gateId]);
+    eLogicLevel level = circuit.gates[sourceId]->GetOutputState();
+    for (const Circuit::SConnection& connection : fanout) {
+        fanins[connection.gate][connection.inputIndex] = sourceId;
+        circuit.fanouts[sourceId].push_back(connection);
+        DriveConnection(connection.gate, connection.inputIndex, level);
+    }
+}
+
+// Drives a rewired input so the gate state matches its new driver
+void CNetlistOptimizer::DriveConnection(int targetId, int inputIndex, eLogicLevel level) {
+    if (circuit.ApplyInput(targetId, inputIndex, level)) {
+        circuit.Propagate(targetId);
+    }
+}
+
+// Deletes removed gates, renumbers the survivors and returns how many were removed
+int CNetlistOptimizer::Compact() {
+    std::vector<int> newIds(fanins.size(), -1);
+    int removedCount = 0;
+    int nextId = 0;
+    for (size_t gateId = 0; gateId < fanins.size(); ++gateId) {
+        if (removed[gateId]) {
+            ++removedCount;
+            delete circuit.gates[gateId];
+        } else {
+            newIds[gateId] = nextId++;
+        }
+    }
+    if (removedCount == 0) {
+        return 0;
+    }
+
+    size_t survivors = static_cast<size_t>(nextId);
+    std::vector<CLogicGates*> gates(survivors);
+    std::vector<std::string> gateNames(survivors);
+    std::vector<uint16_t> gateTypeIds(survivors);
+    std::vector<std::vector<Circuit::SConnection>> fanouts(survivors);
+    std::vector<std::vector<eLogicLevel>> tiedInputs(survivors);
+    for (size_t gateId = 0; gateId < fanins.size(); ++gateId) {
+        int newId = newIds[gateId];
+        if (newId < 0) {
+            continue;
+        }
+        gates[newId] = circuit.gates[gateId];
+        gateNames[newId] = circuit.gateNames[gateId];
+        gateTypeIds[newId] = circuit.gateTypeIds[gateId];
+        tiedInputs[newId] = circuit.tiedInputs[gateId];
+        for (const Circuit::SConnection& connection : circuit.fanouts[gateId]) {
+            fanouts[newId].push_back({newIds[connection.gate], connection.inputIndex});
+        }
+    }
+
+    circuit.gates.swap(gates);
+    circuit.gateNames.swap(gateNames);
+    circuit.gateTypeIds.swap(gateTypeIds);
+    circuit.fanouts.swap(fanouts);
+    circuit.tiedInputs.swap(tiedInputs);
+    circuit.dirty.assign(survivors, false);
+    circuit.pruned.assign(survivors, false);
+    circuit.stats.Remap(newIds, survivors);
+    if (circuit.vcdWriter) {
+        circuit.vcdWriter->Remap(newIds);
+    }
+    circuit.gateIds.clear();
+    circuit.registers.clear();
+    for (size_t gateId = 0; gateId < circuit.gates.size(); ++gateId) {
+        circuit.gateIds[circuit.gateNames[gateId]] = static_cast<int>(gateId);
+        if (circuit.gates[gateId]->IsSequential()) {
+            circuit.registers.push_back(static_cast<int>(gateId));
+        }
+    }
+    circuit.levelsDirty = true;
+    return removedCount;
+}
@@ -1,8 +1,9 @@
 #include "COneBitComparator.h"
+#include "CAig.h"
 
 // Constructor to initialize the comparator with two undefined inputs
 COneBitComparator::COneBitComparator() {
-    inputs.resize(2, eLogicLevel::LOGIC_UNDEFINED);
+    SetInputCount(2);
 }
 
 // Sets the logic level of for a input index and recomputes the output
@@ -16,6 +17,16 @@ eLogicLevel COneBitComparator::GetOutputState() const {
     return outputValue;
 }
 
+// Returns a copy of the gate including its current input and output levels
+CLogicGates* COneBitComparator::Clone() const {
+    return new COneBitComparator(*this);
+}
+
+// Returns the bytes the gate occupies; its inputs are stored inline
+size_t COneBitComparator::GetMemoryBytes() const {
+    return sizeof(*this) + GetInputHeapBytes();
+}
+
 // Computes the outputs for greater, equal, and less based on the two inputs
 void COneBitComparator::ComputeOutput() {
     if (inputs[0] == eLogicLevel::LOGIC_HIGH && inputs[1] == eLogicLevel::LOGIC_LOW) {
@@ -35,6 +46,21 @@ void COneBitComparator::ComputeOutput() {
     }
 }
 
+// Returns the number of held output levels: greater, equal and less
+int COneBitComparator::GetStateCount() const {
+    return 3;
+}
+
+// Returns the greater (0), equal (1) or less (2) output level
+eLogicLevel COneBitComparator::GetState(int stateIndex) const {
+    return (stateIndex == 0) ? greater : (stateIndex == 1) ? equal : less;
+}
+
+// Restores the greater (0), equal (1) or less (2) output level
+void COneBitComparator::SetState(int stateIndex, eLogicLevel level) {
+    (stateIndex == 0 ? greater : stateIndex == 1 ? equal : less) = level;
+}
+
 // Returns the output state for "greater than" comparison
 eLogicLevel COneBitComparator::GetGreaterOutput() const {
     return greater;
@@ -49,3 +75,12 @@ eLogicLevel COneBitComparator::GetEqualOutput() const {
 eLogicLevel COneBitComparator::GetLessOutput() const {
     return less;
 }
+
+// Lowers the comparator into the AND-inverter graph as greater, equal and less outputs
+void COneBitComparator::LowerToAig(CAig& aig, const std::vector<uint32_t>& inputLiterals,
+                                   std::vector<uint32_t>& outputLiterals) const {
+    uint32_t greaterLiteral = aig.AddAnd(inputLiterals[0], CAig::Not(inputLiterals[1]));
+    uint32_t lessLiteral = aig.AddAnd(CAig::Not(inputLiterals[0]), inputLiterals[1]);
+    uint32_t equalLiteral = aig.AddAnd(CAig::Not(greaterLiteral), CAig::Not(lessLiteral));
+    outputLiterals = {greaterLiteral, equalLiteral, lessLiteral};
+}
@@ -1,8 +1,9 @@
 #include "COrGate.h"
+#include "CAig.h"
 
-// Constructor to initialize OR gate with two undefined inputs
-COrGates::COrGates() {
-    inputs.resize(2, eLogicLevel::LOGIC_UNDEFINED);
+// Constructor to initialize OR gate (NOR when inverted) with undefined inputs
+COrGates::COrGates(int inputCount, bool inverted) : inverted(inverted) {
+    SetInputCount(inputCount);
 }
 
 // Sets the logic level of a specific input and recomputes the output
@@ -16,8 +17,31 @@ eLogicLevel COrGates::GetOutputState() const {
     return outputValue;
 }
 
-// Computes the OR gate's output based on its two inputs
+// Returns a copy of the gate including its current input and output levels
+CLogicGates* COrGates::Clone() const {
+    return new COrGates(*this);
+}
+
+// Returns the bytes the gate occupies; its inputs are stored inline
+size_t COrGates::GetMemoryBytes() const {
+    return sizeof(*this) + GetInputHeapBytes();
+}
+
+// Computes the OR gate's output: high if any input is high, as a vectorizable reduction
 void COrGates::ComputeOutput() {
-    outputValue = (inputs[0] == eLogicLevel::LOGIC_HIGH || inputs[1] == eLogicLevel::LOGIC_HIGH) 
-                    ? eLogicLevel::LOGIC_HIGH: eLogicLevel::LOGIC_LOW;
+    bool anyHigh = false;
+    for (int inputIndex = 0; inputIndex < inputCount; ++inputIndex) {
+        anyHigh |= (inputs[inputIndex] == eLogicLevel::LOGIC_HIGH);
+    }
+    outputValue = (anyHigh != inverted) ? eLogicLevel::LOGIC_HIGH : eLogicLevel::LOGIC_LOW;
+}
+
+// Lowers the OR gate into the AND-inverter graph
+void COrGates::LowerToAig(CAig& aig, const std::vector<uint32_t>& inputLiterals,
+                          std::vector<uint32_t>& outputLiterals) const {
+    uint32_t literal = inputLiterals[0];
+    for (size_t input = 1; input < inputLiterals.size(); ++input) {
+        literal = aig.AddOr(literal, inputLiterals[input]);
+    }
+    outputLiterals.assign(1, inverted ? CAig::Not(literal) : literal);
 }
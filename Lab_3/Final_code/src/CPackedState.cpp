@@ -0,0 +1,73 @@
+#include "CPackedState.h"
+#include "Circuit.h"
+#include <cstring>
+
+static const uint64_t UNDEFINED_WORD = 0xAAAAAAAAAAAAAAAAULL;  // 32 undefined nets
+static const uint64_t LOW_BITS = 0x5555555555555555ULL;        // Low bit of every net
+
+// Returns one bit per net, at the net's low bit, for nets whose codes differ
+static uint64_t DifferingNets(uint64_t left, uint64_t right) {
+    uint64_t difference = left ^ right;
+    return (difference | (difference >> 1)) & LOW_BITS;
+}
+
+// Copies the held outputs of every gate into the snapshot, filling whole words at a time
+void CPackedState::Capture(const Circuit& circuit) {
+    words.clear();
+    netCount = 0;
+    uint64_t word = 0;
+    int shift = 0;
+    for (int gateId = 0; gateId < circuit.GetGateCount(); ++gateId) {
+        const CLogicGates* gate = circuit.GetGate(gateId);
+        for (int stateIndex = 0; stateIndex < gate->GetStateCount(); ++stateIndex) {
+            word |= Encode(gate->GetState(stateIndex)) << shift;
+            shift += 2;
+            if (shift == 64) {
+                words.push_back(word);
+                word = 0;
+                shift = 0;
+            }
+            ++netCount;
+        }
+    }
+    if (shift > 0) {
+        words.push_back(word | (UNDEFINED_WORD << shift));  // Unused tail nets read as undefined
+    }
+}
+
+// Returns the number of nets held
+size_t CPackedState::GetNetCount() const {
+    return netCount;
+}
+
+// Returns the bytes used by the packed words
+size_t CPackedState::GetMemoryBytes() const {
+    return words.capacity() * sizeof(uint64_t);
+}
+
+// Returns true if both states hold the same nets at the same levels
+bool CPackedState::Equals(const CPackedState& other) const {
+    return netCount == other.netCount 
+        && std::memcmp(words.data(), other.words.data(), words.size() * sizeof(uint64_t)) == 0;
+}
+
+// Counts the nets whose levels differ; both states must have the same nets
+size_t CPackedState::CountDifferences(const CPackedState& other) const {
+    size_t count = 0;
+    for (size_t word = 0; word < words.size(); ++word) {
+        count += __builtin_popcountll(DifferingNets(words[word], other.words[word]));
+    }
+    return count;
+}
+
+// Lists the nets whose levels differ, in ascending order; both states must have the same nets
+void CPackedState::Diff(const CPackedState& other, std::vector<size_t>& nets) const {
+    nets.clear();
+    for (size_t word = 0; word < words.size(); ++word) {
+        uint64_t differing = DifferingNets(words[word], other.words[word]);
+        while (differing) {
+            nets.push_back(word * NETS_PER_WORD + __builtin_ctzll(differing) / 2);
+            differing &= differing - 1;
+        }
+    }
+}
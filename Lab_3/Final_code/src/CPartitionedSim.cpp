@@ -0,0 +1,478 @@
+#include "CPartitionedSim.h"
+#include "CFileReader.h"
+#include "CGateRegistry.h"
+#include "CPartitioner.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <sstream>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Reads an optional count that follows on the same line, or returns the default
+static int ReadOptionalCount(std::istream& in, int defaultCount) {
+    while (in.peek() == ' ' || in.peek() == '\t') {
+        in.get();
+    }
+    int count = defaultCount;
+    if (std::isdigit(in.peek())) {
+        in >> count;
+    }
+    return count;
+}
+
+// Constructor for a simulation split over the given number of worker processes
+CPartitionedSim::CPartitionedSim(int partCount) : partCount(std::max(1, partCount)) {}
+
+// Destructor that stops any workers still running
+CPartitionedSim::~CPartitionedSim() {
+    Stop();
+}
+
+// Returns the number of gate outputs that cross between parts
+size_t CPartitionedSim::GetCutNetCount() const {
+    return cutNetCount;
+}
+
+// Reads netlist and stimulus commands and prints what the single-process
+// simulator would print; returns false if the workers could not be started
+bool CPartitionedSim::Run(std::istream& input, std::ostream& output) {
+    std::string request, gateName, outputType, rest;
+    while (input >> request) {
+        if (request[0] == '#') {
+            std::getline(input, rest);  // Ignores comment lines
+            continue;
+        }
+        if (ReadNetlistCommand(request, input)) {
+            continue;
+        }
+        if (request == "end") {
+            break;
+        }
+        if (!partitioned && !Partition()) {
+            return false;
+        }
+
+        if (request == "input") {
+            int inputIndex = 0, level = 0;
+            input >> gateName >> inputIndex >> level;
+            int gate = FindGate(gateName);
+            if (gate < 0) {
+                std::cerr << "Error: Gate " << gateName << " not found." << std::endl;
+            } else if (inputIndex < 0 || inputIndex >= gates[gate].width) {
+                std::cerr << "Error: Gate " << gateName << " has no input " << inputIndex << "." << std::endl;
+            } else {
+                workers[gates[gate].part]->Write("D " + std::to_string(gates[gate].localId) + " " 
+                    + std::to_string(inputIndex) + " " + std::to_string(level) + "\n");
+                pending[gates[gate].part] = true;  // Settled before the next query or clock
+                output << "Input Index " << inputIndex << " of " << gateName 
+                       << " gate runs with logic " << level << '\n';
+            }
+        } else if (request == "clock") {
+            int cycles = 0;
+            input >> cycles;
+            Settle();
+            for (int cycle = 0; cycle < cycles; ++cycle) {
+                // Like Circuit::Clock, every connection is driven again before the registers
+                // latch, overriding levels that stimulus put on connected inputs
+                RedriveCutNets();
+                std::vector<bool> everyPart(partCount, true);
+                Exchange("R", everyPart);
+                pending.swap(everyPart);
+                Settle();
+                everyPart.assign(partCount, true);
+                Exchange("C", everyPart);  // All registers latch before any cut net moves
+                pending.swap(everyPart);
+                Settle();
+            }
+        } else if (request == "output") {
+            input >> gateName;
+            Settle();
+            int gate = FindGate(gateName);
+            if (gate < 0) {
+                std::cerr << "Error: Gate " << gateName << " not found." << std::endl;
+            }
+            output << "Gate " << gateName << " output: " << ((gate < 0) ? -1 : QueryLevel(gate, "")) << '\n';
+        } else if (request == "comparator_output") {
+            input >> gateName >> outputType;
+            Settle();
+            int gate = FindGate(gateName);
+            if (gate < 0) {
+                std::cerr << "Error: Gate " << gateName << " not found or not a comparator." << std::endl;
+            }
+            output << gateName << " " << outputType << " output: " 
+                   << ((gate < 0) ? -1 : QueryLevel(gate, outputType)) << '\n';
+        } else if (request == "record") {
+            Settle();
+            WriteRecord(output);
+        } else {
+            std::cerr << "Error: " << request << " is not supported in partitioned mode." << std::endl;
+            std::getline(input, rest);
+        }
+    }
+    Stop();
+    output.flush();
+    return true;
+}
+
+// Handles component, connect, tie and observe; returns false for other commands
+bool CPartitionedSim::ReadNetlistCommand(const std::string& request, std::istream& input) {
+    std::string gateType, gateName, targetName;
+    int inputIndex = 0, level = 0;
+    if (request == "observe") {
+        input >> gateName;
+        observed.push_back(gateName);
+        return true;
+    }
+    if (request != "component" && request != "connect" && request != "tie") {
+        return false;
+    }
+    if (partitioned) {
+        std::getline(input, gateName);
+        std::cerr << "Error: The netlist cannot change once partitioned simulation has started." << std::endl;
+        return true;
+    }
+
+    if (request == "component") {
+        input >> gateType >> gateName;
+        if (gateType == "REG") {
+            int width = ReadOptionalCount(input, 1);  // Register width
+            for (int bit = 0; bit < width; ++bit) {
+                DeclareGate("DFF", gateName + "[" + std::to_string(bit) + "]", 0);
+            }
+        } else {
+            DeclareGate(gateType, gateName, ReadOptionalCount(input, 0));
+        }
+    } else if (request == "connect") {
+        input >> gateName >> targetName >> inputIndex;
+        int source = FindGate(gateName);
+        int target = FindGate(targetName);
+        if (source < 0 || target < 0) {
+            std::cerr << "Error: Cannot connect " << gateName 
+                      << " to " << targetName << ", gate not found." << std::endl;
+        } else if (inputIndex < 0 || inputIndex >= gates[target].width) {
+            std::cerr << "Error: Gate " << targetName << " has no input " << inputIndex << "." << std::endl;
+        } else {
+            edges.push_back({source, target, inputIndex});
+        }
+    } else {
+        input >> gateName >> inputIndex >> level;
+        int gate = FindGate(gateName);
+        if (gate < 0 || inputIndex < 0 || inputIndex >= gates[gate].width || (level != 0 && level != 1)) {
+            std::cerr << "Error: Cannot tie input " << inputIndex << " of " << gateName << "." << std::endl;
+        } else {
+            ties.push_back({gate, inputIndex, level});
+        }
+    }
+    return true;
+}
+
+// Adds a gate to the table, checking it the way Circuit::AddGate does
+void CPartitionedSim::DeclareGate(const std::string& gateType, const std::string& gateName, int inputCount) {
+    const CGateRegistry& registry = CGateRegistry::Instance();
+    int typeId = registry.FindType(gateType);
+    if (typeId < 0) {
+        std::cerr << "Error: Unknown gate type " << gateType << std::endl;
+        return;
+    }
+    if (!registry.AcceptsInputCount(typeId, inputCount)) {
+        std::cerr << "Error: Gate " << gateName << " cannot have " << inputCount << " inputs." << std::endl;
+        return;
+    }
+    if (!gateIds.emplace(gateName, static_cast<int>(gates.size())).second) {
+        std::cerr << "Error: Gate " << gateName << " already exists." << std::endl;
+        return;
+    }
+    const CLogicGates* gate = registry.Create(typeId, inputCount);  // Probed for its shape only
+    gates.push_back({gateName, gateType, inputCount, gate->GetInputCount(), gate->GetStateCount() == 3});
+    delete gate;
+}
+
+// Splits the netlist and starts one worker process per part
+bool CPartitionedSim::Partition() {
+    partitioned = true;
+    partCount = std::max(1, std::min(partCount, static_cast<int>(gates.size())));
+    CPartitioner partitioner(static_cast<int>(gates.size()));
+    for (const SEdge& edge : edges) {
+        partitioner.AddEdge(edge.source, edge.target);
+    }
+    std::vector<int> parts = partitioner.Run(partCount);
+    cutNetCount = partitioner.CountCutNets(parts);
+
+    // Each worker gets its gates, the connections inside its part and its ties
+    std::vector<std::string> netlists(partCount);
+    std::vector<int> localCounts(partCount, 0);
+    for (size_t gate = 0; gate < gates.size(); ++gate) {
+        SNetGate& netGate = gates[gate];
+        netGate.part = parts[gate];
+        netGate.localId = localCounts[netGate.part]++;
+        netlists[netGate.part] += "component " + netGate.type + " " + netGate.name 
+            + ((netGate.inputCount > 0) ? " " + std::to_string(netGate.inputCount) : "") + "\n";
+    }
+    std::vector<std::vector<int>> cutGates(partCount);  // Local ids of each part's cut nets
+    std::vector<int> cutIndex(gates.size(), -1);
+    cutFanouts.assign(partCount, {});
+    cutLevels.assign(partCount, {});
+    for (const SEdge& edge : edges) {
+        const SNetGate& source = gates[edge.source];
+        const SNetGate& target = gates[edge.target];
+        if (source.part == target.part) {
+            netlists[source.part] += "connect " + source.name + " " + target.name + " " 
+                                   + std::to_string(edge.inputIndex) + "\n";
+            continue;
+        }
+        if (cutIndex[edge.source] < 0) {
+            cutIndex[edge.source] = static_cast<int>(cutGates[source.part].size());
+            cutGates[source.part].push_back(source.localId);
+            cutFanouts[source.part].emplace_back();
+            cutLevels[source.part].push_back(static_cast<int>(eLogicLevel::LOGIC_UNDEFINED));
+        }
+        cutFanouts[source.part][cutIndex[edge.source]].push_back({target.part, target.localId, edge.inputIndex});
+    }
+    for (const STie& tie : ties) {
+        netlists[gates[tie.gate].part] += "tie " + gates[tie.gate].name + " " + std::to_string(tie.inputIndex) 
+                                        + " " + std::to_string(tie.level) + "\n";
+    }
+
+    std::cout.flush();  // Buffered output must not be written again by the children
+    std::cerr.flush();
+    for (int part = 0; part < partCount; ++part) {
+        int fds[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0) {
+            std::cerr << "Error: Cannot create a socket pair for worker " << part << "." << std::endl;
+            return false;
+        }
+        pid_t workerId = fork();
+        if (workerId < 0) {
+            std::cerr << "Error: Cannot start worker " << part << "." << std::endl;
+            close(fds[0]);
+            close(fds[1]);
+            return false;
+        }
+        if (workerId == 0) {
+            close(fds[0]);
+            for (std::unique_ptr<CSimConnection>& worker : workers) {
+                worker->Close();  // Sockets of the earlier workers belong to the coordinator
+            }
+            RunWorker(part, fds[1], netlists[part] + "end\n", cutGates[part]);
+            _exit(0);
+        }
+        close(fds[1]);
+        workers.emplace_back(new CSimConnection(fds[0]));
+        workerIds.push_back(workerId);
+    }
+    pending.assign(partCount, false);
+    return true;
+}
+
+// Worker loop: builds the part and answers the coordinator until told to stop.
+//   D <gate> <input> <level>   drives a gate input
+//   S                          reports the cut nets that changed, then "."
+//   R                          drives every connection of the part again, then reports like S
+//   C                          clocks once, then reports like S
+//   Q <gate>                   replies with the gate output
+//   K <gate> <output>          replies with a comparator output
+//   F                          sends the buffered replies
+//   E                          stops
+void CPartitionedSim::RunWorker(int part, int fd, const std::string& netlist, const std::vector<int>& cutGates) {
+    Circuit circuit;
+    {
+        std::istringstream netlistInput(netlist);
+        std::ostringstream ignored;
+        CFileReader fileReader(circuit, netlistInput, ignored);
+        fileReader.ProcessInput();
+    }
+
+    CSimConnection connection(fd);
+    std::vector<eLogicLevel> reported(cutGates.size(), eLogicLevel::LOGIC_UNDEFINED);
+    std::string line;
+    while (connection.ReadLine(line) && !line.empty()) {
+        char* field = &line[1];
+        switch (line[0]) {
+        case 'D': {
+            int gate = static_cast<int>(std::strtol(field, &field, 10));
+            int inputIndex = static_cast<int>(std::strtol(field, &field, 10));
+            int level = static_cast<int>(std::strtol(field, &field, 10));
+            circuit.DriveGate(gate, inputIndex, static_cast<eLogicLevel>(level));
+            break;
+        }
+        case 'R':
+            circuit.Clock(0);  // Zero cycles only evaluates the logic in level order
+            [[fallthrough]];
+        case 'C':
+            if (line[0] == 'C') {
+                circuit.Clock(1);
+            }
+            [[fallthrough]];
+        case 'S':
+            for (size_t cut = 0; cut < cutGates.size(); ++cut) {
+                eLogicLevel level = circuit.GetGateOutput(cutGates[cut]);
+                if (level != reported[cut]) {
+                    reported[cut] = level;
+                    connection.Write(std::to_string(cut) + " " + std::to_string(static_cast<int>(level)) + "\n");
+                }
+            }
+            connection.Write(".\n");
+            connection.Flush();
+            break;
+        case 'Q':
+            connection.Write(std::to_string(static_cast<int>(circuit.GetGateOutput(std::atoi(field)))) + "\n");
+            break;
+        case 'K': {
+            int gate = static_cast<int>(std::strtol(field, &field, 10));
+            std::string outputType(field + 1);
+            connection.Write(std::to_string(static_cast<int>(circuit.GetComparatorOutput(gate, outputType))) + "\n");
+            break;
+        }
+        case 'F':
+            connection.Flush();
+            break;
+        case 'E':
+            return;
+        }
+    }
+}
+
+// Sends a request to the marked parts and forwards the cut-net changes they
+// report; afterwards the marks name the parts that received new levels
+void CPartitionedSim::Exchange(const char* request, std::vector<bool>& parts) {
+    for (int part = 0; part < partCount; ++part) {
+        if (parts[part]) {
+            workers[part]->Write(std::string(request) + "\n");
+            workers[part]->Flush();  // Every part works on its request at the same time
+        }
+    }
+    std::vector<bool> driven(partCount, false);
+    std::string line;
+    for (int part = 0; part < partCount; ++part) {
+        while (parts[part] && workers[part]->ReadLine(line) && line != ".") {
+            char* field = &line[0];
+            int cut = static_cast<int>(std::strtol(field, &field, 10));
+            cutLevels[part][cut] = static_cast<int>(std::strtol(field, &field, 10));
+            DriveCutNet(part, cut, driven);
+        }
+    }
+    parts.swap(driven);
+}
+
+// Queues the level of a cut net onto every gate input it feeds in other parts
+void CPartitionedSim::DriveCutNet(int part, int cut, std::vector<bool>& driven) {
+    std::string level = std::to_string(cutLevels[part][cut]);
+    for (const SRemoteInput& remote : cutFanouts[part][cut]) {
+        workers[remote.part]->Write("D " + std::to_string(remote.localId) + " " 
+                                    + std::to_string(remote.inputIndex) + " " + level + "\n");
+        driven[remote.part] = true;
+    }
+}
+
+// Queues every cut net again with its last reported level
+void CPartitionedSim::RedriveCutNets() {
+    for (int part = 0; part < partCount; ++part) {
+        for (size_t cut = 0; cut < cutFanouts[part].size(); ++cut) {
+            DriveCutNet(part, static_cast<int>(cut), pending);
+        }
+    }
+}
+
+// Exchanges cut nets until no part has unsettled drives
+void CPartitionedSim::Settle() {
+    size_t roundLimit = gates.size() + 2;  // A level crosses the cut at most once per gate on its path
+    for (size_t round = 0; std::find(pending.begin(), pending.end(), true) != pending.end(); ++round) {
+        if (round > roundLimit) {
+            std::cerr << "Error: Circuit did not settle, check for combinational loops." << std::endl;
+            pending.assign(partCount, false);
+            return;
+        }
+        Exchange("S", pending);
+    }
+}
+
+// Tells every worker to stop and waits for them
+void CPartitionedSim::Stop() {
+    for (size_t part = 0; part < workers.size(); ++part) {
+        workers[part]->Write("E\n");
+        workers[part]->Flush();
+        workers[part]->Close();
+        waitpid(workerIds[part], nullptr, 0);
+    }
+    workers.clear();
+    workerIds.clear();
+}
+
+// Returns the index of a named gate, or -1 if it does not exist
+int CPartitionedSim::FindGate(const std::string& gateName) const {
+    auto it = gateIds.find(gateName);
+    return (it != gateIds.end()) ? it->second : -1;
+}
+
+// Asks the owning worker for a gate output, or a comparator output if a type is given
+int CPartitionedSim::QueryLevel(int gate, const std::string& outputType) {
+    CSimConnection& worker = *workers[gates[gate].part];
+    std::string query = outputType.empty() ? "Q " : "K ";
+    worker.Write(query + std::to_string(gates[gate].localId) 
+                 + (outputType.empty() ? "" : " " + outputType) + "\nF\n");
+    worker.Flush();
+    std::string line;
+    worker.ReadLine(line);
+    return std::atoi(line.c_str());
+}
+
+// Writes one record over the observed gates, in the format of the record command
+void CPartitionedSim::WriteRecord(std::ostream& output) {
+    static const char* comparatorOutputs[] = {"greater", "equal", "less"};
+    static const char levelCharacters[] = {'X', '0', '1'};
+    if (headerOutputs != observed.size()) {
+        output << "outputs";
+        for (const std::string& gateName : observed) {
+            int gate = FindGate(gateName);
+            if (gate >= 0 && gates[gate].comparator) {
+                for (const char* outputType : comparatorOutputs) {
+                    output << " " << gateName << "." << outputType;
+                }
+            } else {
+                output << " " << gateName;
+            }
+        }
+        output << '\n';
+        headerOutputs = observed.size();
+    }
+
+    // Queries go out to every worker first and the replies are read in order
+    std::vector<bool> queried(partCount, false);
+    for (const std::string& gateName : observed) {
+        int gate = FindGate(gateName);
+        if (gate < 0) {
+            continue;
+        }
+        CSimConnection& worker = *workers[gates[gate].part];
+        std::string localId = std::to_string(gates[gate].localId);
+        if (gates[gate].comparator) {
+            for (const char* outputType : comparatorOutputs) {
+                worker.Write("K " + localId + " " + outputType + "\n");
+            }
+        } else {
+            worker.Write("Q " + localId + "\n");
+        }
+        queried[gates[gate].part] = true;
+    }
+    for (int part = 0; part < partCount; ++part) {
+        if (queried[part]) {
+            workers[part]->Write("F\n");
+            workers[part]->Flush();
+        }
+    }
+    std::string record, line;
+    for (const std::string& gateName : observed) {
+        int gate = FindGate(gateName);
+        int replies = (gate < 0) ? 0 : gates[gate].comparator ? 3 : 1;
+        if (gate < 0) {
+            record += 'X';
+        }
+        for (int reply = 0; reply < replies; ++reply) {
+            workers[gates[gate].part]->ReadLine(line);
+            record += levelCharacters[std::atoi(line.c_str()) + 1];
+        }
+    }
+    output << record << '\n';
+}
@@ -0,0 +1,101 @@
+#include "CPartitioner.h"
+#include <algorithm>
+
+static const int REFINE_PASSES = 8;       // Upper bound on refinement sweeps
+static const double BALANCE_SLACK = 0.05; // Parts may differ from the mean size by this fraction
+
+// Constructor for a graph of unconnected gates
+CPartitioner::CPartitioner(int gateCount) : fanouts(gateCount), neighbours(gateCount) {}
+
+// Adds a connection from a gate output to another gate
+void CPartitioner::AddEdge(int source, int target) {
+    fanouts[source].push_back(target);
+    if (source != target) {
+        neighbours[source].push_back(target);
+        neighbours[target].push_back(source);
+    }
+}
+
+// Returns every gate once, connected gates close together
+std::vector<int> CPartitioner::BreadthFirstOrder() const {
+    std::vector<int> order;
+    std::vector<bool> visited(neighbours.size(), false);
+    order.reserve(neighbours.size());
+    for (size_t start = 0; start < neighbours.size(); ++start) {
+        if (visited[start]) {
+            continue;
+        }
+        visited[start] = true;
+        order.push_back(static_cast<int>(start));
+        for (size_t next = order.size() - 1; next < order.size(); ++next) {
+            for (int neighbour : neighbours[order[next]]) {
+                if (!visited[neighbour]) {
+                    visited[neighbour] = true;
+                    order.push_back(neighbour);
+                }
+            }
+        }
+    }
+    return order;
+}
+
+// Assigns every gate a part in 0 .. partCount-1
+std::vector<int> CPartitioner::Run(int partCount) const {
+    size_t gateCount = neighbours.size();
+    std::vector<int> parts(gateCount, 0);
+    if (partCount <= 1 || gateCount == 0) {
+        return parts;
+    }
+
+    std::vector<int> order = BreadthFirstOrder();
+    std::vector<size_t> sizes(partCount, 0);
+    for (size_t rank = 0; rank < gateCount; ++rank) {
+        int part = static_cast<int>(rank * partCount / gateCount);  // Equal slices of the order
+        parts[order[rank]] = part;
+        ++sizes[part];
+    }
+
+    double mean = static_cast<double>(gateCount) / partCount;
+    size_t maxSize = static_cast<size_t>(mean * (1.0 + BALANCE_SLACK)) + 1;
+    size_t minSize = static_cast<size_t>(mean * (1.0 - BALANCE_SLACK));
+    std::vector<int> links(partCount, 0);  // Edges from the gate under test into each part
+    for (int pass = 0; pass < REFINE_PASSES; ++pass) {
+        size_t moves = 0;
+        for (int gate : order) {
+            int home = parts[gate];
+            for (int neighbour : neighbours[gate]) {
+                ++links[parts[neighbour]];
+            }
+            int best = home;
+            for (int neighbour : neighbours[gate]) {
+                int part = parts[neighbour];
+                if (links[part] > links[best] && sizes[part] < maxSize) {
+                    best = part;
+                }
+            }
+            for (int neighbour : neighbours[gate]) {
+                links[parts[neighbour]] = 0;
+            }
+            if (best != home && sizes[home] > minSize) {
+                parts[gate] = best;
+                --sizes[home];
+                ++sizes[best];
+                ++moves;
+            }
+        }
+        if (moves == 0) {
+            break;
+        }
+    }
+    return parts;
+}
+
+// Returns the number of gate outputs that drive a gate in another part
+size_t CPartitioner::CountCutNets(const std::vector<int>& parts) const {
+    size_t cutNets = 0;
+    for (size_t source = 0; source < fanouts.size(); ++source) {
+        cutNets += std::any_of(fanouts[source].begin(), fanouts[source].end(), 
+                               [&](int target) { return parts[target] != parts[source]; });
+    }
+    return cutNets;
+}
@@ -0,0 +1,54 @@
+#include "CSimClient.h"
+#include <sstream>
+
+// Connects to the server listening on the socket path
+bool CSimClient::Connect(const std::string& socketPath) {
+    int fd = CSimConnection::Connect(socketPath);
+    if (fd < 0) {
+        return false;
+    }
+    connection.Open(fd);
+    return true;
+}
+
+// Sends netlist commands to be built and cached under the name
+bool CSimClient::Load(const std::string& circuitName, const std::string& netlist, SSimReply& reply) {
+    return Request("LOAD " + circuitName + " " + std::to_string(netlist.size()), netlist, reply);
+}
+
+// Runs simulation commands on a fresh copy of the named circuit
+bool CSimClient::Run(const std::string& circuitName, const std::string& commands, SSimReply& reply) {
+    return Request("RUN " + circuitName + " " + std::to_string(commands.size()), commands, reply);
+}
+
+// Removes the named circuit from the server's cache
+bool CSimClient::Drop(const std::string& circuitName, SSimReply& reply) {
+    return Request("DROP " + circuitName, "", reply);
+}
+
+// Asks the server to exit
+bool CSimClient::Shutdown() {
+    SSimReply reply;
+    return Request("SHUTDOWN", "", reply);
+}
+
+// Sends one request and waits for its reply; returns false if the connection failed
+bool CSimClient::Request(const std::string& header, const std::string& body, SSimReply& reply) {
+    reply = SSimReply();
+    if (!connection.IsOpen()) {
+        return false;
+    }
+    connection.Write(header + "\n");
+    connection.Write(body);
+    std::string status;
+    if (!connection.Flush() || !connection.ReadLine(status)) {
+        return false;
+    }
+
+    std::istringstream fields(status);
+    std::string result;
+    size_t outputBytes = 0, errorBytes = 0;
+    fields >> result >> outputBytes >> errorBytes;
+    reply.ok = (result == "OK");
+    return connection.ReadBytes(outputBytes, reply.output) && connection.ReadBytes(errorBytes, reply.errors);
+}
@@ -0,0 +1,164 @@
+#include "CSimConnection.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static const size_t READ_BYTES = 64 * 1024;  // Bytes requested from the socket per read
+
+// Fills in a Unix socket address, returning false if the path is too long
+static bool MakeAddress(const std::string& socketPath, sockaddr_un& address) {
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Error: Socket path " << socketPath << " is too long." << std::endl;
+        return false;
+    }
+    std::strcpy(address.sun_path, socketPath.c_str());
+    return true;
+}
+
+// Constructor that takes ownership of a connected socket, -1 for none
+CSimConnection::CSimConnection(int fd) : fd(fd) {}
+
+// Destructor that closes the socket
+CSimConnection::~CSimConnection() {
+    Close();
+}
+
+// Creates a listening socket at the path, replacing a stale one; returns -1 on failure
+int CSimConnection::Listen(const std::string& socketPath) {
+    sockaddr_un address;
+    if (!MakeAddress(socketPath, address)) {
+        return -1;
+    }
+    int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        std::cerr << "Error: Cannot create socket: " << std::strerror(errno) << std::endl;
+        return -1;
+    }
+    unlink(socketPath.c_str());
+    if (bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 
+        || listen(listenFd, SOMAXCONN) < 0) {
+        std::cerr << "Error: Cannot listen on " << socketPath << ": " << std::strerror(errno) << std::endl;
+        close(listenFd);
+        return -1;
+    }
+    return listenFd;
+}
+
+// Connects to a listening socket; returns -1 on failure
+int CSimConnection::Connect(const std::string& socketPath) {
+    sockaddr_un address;
+    if (!MakeAddress(socketPath, address)) {
+        return -1;
+    }
+    int connectFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (connectFd < 0) {
+        std::cerr << "Error: Cannot create socket: " << std::strerror(errno) << std::endl;
+        return -1;
+    }
+    if (connect(connectFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        std::cerr << "Error: Cannot connect to " << socketPath << ": " << std::strerror(errno) << std::endl;
+        close(connectFd);
+        return -1;
+    }
+    return connectFd;
+}
+
+// Replaces the socket with a newly connected one
+void CSimConnection::Open(int newFd) {
+    Close();
+    fd = newFd;
+}
+
+// Returns true while a socket is attached
+bool CSimConnection::IsOpen() const {
+    return fd >= 0;
+}
+
+// Closes the socket and discards buffered data
+void CSimConnection::Close() {
+    if (fd >= 0) {
+        close(fd);
+        fd = -1;
+    }
+    readBuffer.clear();
+    readPosition = 0;
+    writeBuffer.clear();
+}
+
+// Reads up to and excluding the next newline; returns false at end of stream
+bool CSimConnection::ReadLine(std::string& line) {
+    line.clear();
+    while (true) {
+        size_t newline = readBuffer.find('\n', readPosition);
+        if (newline != std::string::npos) {
+            line.append(readBuffer, readPosition, newline - readPosition);
+            readPosition = newline + 1;
+            return true;
+        }
+        line.append(readBuffer, readPosition, std::string::npos);
+        readPosition = readBuffer.size();
+        if (!Fill()) {
+            return false;
+        }
+    }
+}
+
+// Reads exactly count bytes; returns false if the stream ends first. Storage grows with
+// the bytes that arrive, so a bogus count cannot reserve memory up front.
+bool CSimConnection::ReadBytes(size_t count, std::string& data) {
+    data.clear();
+    data.reserve(std::min(count, READ_BYTES));
+    while (data.size() < count) {
+        if (readPosition == readBuffer.size() && !Fill()) {
+            return false;
+        }
+        size_t take = std::min(count - data.size(), readBuffer.size() - readPosition);
+        data.append(readBuffer, readPosition, take);
+        readPosition += take;
+    }
+    return true;
+}
+
+// Queues data to be sent by the next Flush
+void CSimConnection::Write(const std::string& data) {
+    writeBuffer += data;
+}
+
+// Sends all queued data; returns false if the peer has gone
+bool CSimConnection::Flush() {
+    size_t sent = 0;
+    while (sent < writeBuffer.size()) {
+        ssize_t count = send(fd, writeBuffer.data() + sent, writeBuffer.size() - sent, MSG_NOSIGNAL);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            writeBuffer.clear();
+            return false;
+        }
+        sent += static_cast<size_t>(count);
+    }
+    writeBuffer.clear();
+    return true;
+}
+
+// Replaces the consumed read buffer with the next chunk from the socket
+bool CSimConnection::Fill() {
+    if (fd < 0) {
+        return false;
+    }
+    readBuffer.resize(READ_BYTES);
+    readPosition = 0;
+    ssize_t count;
+    do {
+        count = recv(fd, &readBuffer[0], READ_BYTES, 0);
+    } while (count < 0 && errno == EINTR);
+    readBuffer.resize(count > 0 ? static_cast<size_t>(count) : 0);
+    return count > 0;
+}
@@ -0,0 +1,181 @@
+#include "CSimServer.h"
+#include "CFileReader.h"
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+static const size_t MAX_REQUEST_BYTES = 256 << 20;  // Largest request body a client may send
+
+// Sends the status line, output and error text of one reply
+static bool Reply(CSimConnection& connection, bool ok, const std::string& output, const std::string& errors) {
+    connection.Write(std::string(ok ? "OK " : "ERROR ") + std::to_string(output.size()) 
+                     + " " + std::to_string(errors.size()) + "\n");
+    connection.Write(output);
+    connection.Write(errors);
+    return connection.Flush();
+}
+
+// Runs commands through a file reader, capturing what it prints and its error messages
+static void RunCommands(Circuit& circuit, const std::string& commands, std::string& output, std::string& errors) {
+    std::istringstream input(commands);
+    std::ostringstream printed, errorText;
+    CFileReader fileReader(circuit, input, printed, errorText);
+    fileReader.ProcessInput();
+    circuit.SetErrorStream(std::cerr);  // The captured stream ends with this request
+    output = printed.str();
+    errors = errorText.str();
+}
+
+// Accepts clients until a SHUTDOWN request, serving each on its own thread; returns
+// false if the socket fails
+bool CSimServer::Serve(const std::string& socketPath) {
+    listenFd = CSimConnection::Listen(socketPath);
+    if (listenFd < 0) {
+        return false;
+    }
+
+    bool ok = true;
+    while (true) {
+        int clientFd = accept(listenFd, nullptr, nullptr);
+        if (clientFd < 0 && stopping) {
+            break;  // Stop shut the listening socket down
+        }
+        if (clientFd < 0 && (errno == EINTR || errno == ECONNABORTED)) {
+            continue;  // Interrupted or the client vanished before accept
+        }
+        if (clientFd < 0) {
+            std::cerr << "Error: Cannot accept clients: " << std::strerror(errno) << std::endl;
+            ok = false;
+            Stop();
+            break;
+        }
+
+        std::lock_guard<std::mutex> lock(clientsMutex);
+        if (stopping) {
+            close(clientFd);  // Accepted while shutting down
+            continue;
+        }
+        clientFds.insert(clientFd);
+        activeClients++;
+        std::thread(&CSimServer::ServeClient, this, clientFd).detach();
+    }
+
+    std::unique_lock<std::mutex> lock(clientsMutex);
+    clientsDone.wait(lock, [this] { return activeClients == 0; });
+    lock.unlock();
+    close(listenFd);
+    unlink(socketPath.c_str());
+    return ok;
+}
+
+// Answers one client until it disconnects, stopping the server if it asked to shut down
+void CSimServer::ServeClient(int clientFd) {
+    CSimConnection connection(clientFd);
+    if (!HandleConnection(connection)) {
+        Stop();
+    }
+
+    std::lock_guard<std::mutex> lock(clientsMutex);
+    clientFds.erase(clientFd);  // Before closing, so Stop never touches a reused descriptor
+    connection.Close();
+    if (--activeClients == 0) {
+        clientsDone.notify_all();
+    }
+}
+
+// Wakes the accept loop and ends the reads of every connected client; requests
+// already being answered still get their reply
+void CSimServer::Stop() {
+    std::lock_guard<std::mutex> lock(clientsMutex);
+    stopping = true;
+    shutdown(listenFd, SHUT_RDWR);
+    for (int clientFd : clientFds) {
+        shutdown(clientFd, SHUT_RD);
+    }
+}
+
+// Answers the requests of one client; returns false once asked to shut down. A client
+// announcing an oversized body is answered with an error and dropped.
+bool CSimServer::HandleConnection(CSimConnection& connection) {
+    std::string header, body, output, errors;
+    while (connection.ReadLine(header)) {
+        std::istringstream fields(header);
+        std::string request, circuitName;
+        size_t bodyBytes = 0;
+        fields >> request >> circuitName >> bodyBytes;
+
+        bool ok = false;
+        output.clear();
+        errors.clear();
+        bool hasBody = (request == "LOAD" || request == "RUN");
+        if (hasBody && bodyBytes > MAX_REQUEST_BYTES) {
+            Reply(connection, false, output, "Error: Request body of " + std::to_string(bodyBytes) + " bytes is too large.\n");
+            return true;  // The body is not read, so the stream cannot be resynchronised
+        }
+        if (hasBody && !connection.ReadBytes(bodyBytes, body)) {
+            return true;  // Client went away mid-request
+        }
+        if (request == "LOAD") {
+            ok = Load(circuitName, body, output, errors);
+        } else if (request == "RUN") {
+            ok = Run(circuitName, body, output, errors);
+        } else if (request == "DROP") {
+            ok = Drop(circuitName, errors);
+        } else if (request == "SHUTDOWN") {
+            Reply(connection, true, output, errors);
+            return false;
+        } else {
+            errors = "Error: Unknown request " + request + "\n";
+        }
+        if (!Reply(connection, ok, output, errors)) {
+            return true;
+        }
+    }
+    return true;
+}
+
+// Builds a circuit from netlist commands and caches it under the name, replacing any old one
+bool CSimServer::Load(const std::string& circuitName, const std::string& netlist, std::string& output, std::string& errors) {
+    if (circuitName.empty()) {
+        errors = "Error: Missing circuit name.\n";
+        return false;
+    }
+    auto circuit = std::make_shared<Circuit>();
+    RunCommands(*circuit, netlist, output, errors);
+    std::unique_lock<std::shared_mutex> lock(circuitsMutex);
+    circuits[circuitName] = std::move(circuit);
+    return true;
+}
+
+// Runs commands on a copy of a cached circuit so every run starts from the loaded state
+bool CSimServer::Run(const std::string& circuitName, const std::string& commands, std::string& output, std::string& errors) {
+    std::shared_ptr<const Circuit> loaded;
+    {
+        std::shared_lock<std::shared_mutex> lock(circuitsMutex);
+        auto it = circuits.find(circuitName);
+        if (it != circuits.end()) {
+            loaded = it->second;
+        }
+    }
+    if (!loaded) {
+        errors = "Error: Circuit " + circuitName + " is not loaded.\n";
+        return false;
+    }
+    Circuit circuit(*loaded);
+    RunCommands(circuit, commands, output, errors);
+    return true;
+}
+
+// Forgets a cached circuit; runs that already copied it are not affected
+bool CSimServer::Drop(const std::string& circuitName, std::string& errors) {
+    std::unique_lock<std::shared_mutex> lock(circuitsMutex);
+    if (circuits.erase(circuitName) == 0) {
+        errors = "Error: Circuit " + circuitName + " is not loaded.\n";
+        return false;
+    }
+    return true;
+}
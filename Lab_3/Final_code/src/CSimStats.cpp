@@ -0,0 +1,117 @@
+#include "CSimStats.h"
+#include "CJson.h"
+#include <map>
+
+#ifdef ENABLE_STATS
+// Writes the five counters as JSON members
+static void WriteCounters(std::ostream& out, const SGateCounters& counters) {
+    out << "\"drives\": " << counters.drives 
+        << ", \"elided_drives\": " << counters.elided 
+        << ", \"evaluations\": " << counters.evaluations 
+        << ", \"toggles\": " << counters.toggles 
+        << ", \"redundant_evaluations\": " << counters.redundant;
+}
+#endif
+
+// Starts timing phases; counters are always collected when compiled in
+void CSimStats::Enable() {
+    enabled = true;
+    currentPhase = ePhase::PHASE_PARSE;
+    phaseStart = std::chrono::steady_clock::now();
+}
+
+// Returns true when a report was requested
+bool CSimStats::IsEnabled() const {
+    return enabled;
+}
+
+// Adds counters for a newly created gate
+void CSimStats::AddGate() {
+    gateCounters.emplace_back();
+}
+
+// Moves counters to new gate indices after the netlist was compacted
+void CSimStats::Remap(const std::vector<int>& newIds, size_t gateCount) {
+    std::vector<SGateCounters> remapped(gateCount);
+    for (size_t gateId = 0; gateId < newIds.size(); ++gateId) {
+        if (newIds[gateId] >= 0) {
+            remapped[newIds[gateId]] = gateCounters[gateId];
+        }
+    }
+    gateCounters.swap(remapped);
+}
+
+// Charges the time since the last switch to the current phase and starts the next one
+void CSimStats::SwitchPhase(ePhase phase) {
+    if (!enabled) {
+        return;
+    }
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    phaseSeconds[static_cast<int>(currentPhase)] += std::chrono::duration<double>(now - phaseStart).count();
+    currentPhase = phase;
+    phaseStart = now;
+}
+
+// Returns the counters summed over every gate
+SGateCounters CSimStats::GetTotals() const {
+    SGateCounters totals;
+    for (const SGateCounters& counters : gateCounters) {
+        totals.drives += counters.drives;
+        totals.elided += counters.elided;
+        totals.evaluations += counters.evaluations;
+        totals.toggles += counters.toggles;
+        totals.redundant += counters.redundant;
+    }
+    return totals;
+}
+
+// Writes phase times, per-type totals and per-gate counters as one JSON object
+void CSimStats::WriteJson(std::ostream& out, const std::vector<std::string>& gateNames,
+                          const std::vector<std::string>& gateTypes) {
+    SwitchPhase(currentPhase);  // Close the running phase
+
+    static const char* phaseNames[] = {"parse", "build", "simulate", "output"};
+    out << "{\n  \"phases_ms\": {";
+    for (int phase = 0; phase < static_cast<int>(ePhase::PHASE_COUNT); ++phase) {
+        out << (phase ? ", " : "") << '"' << phaseNames[phase] << "\": " << phaseSeconds[phase] * 1000.0;
+    }
+    out << "},\n";
+
+#ifdef ENABLE_STATS
+    std::map<std::string, std::pair<size_t, SGateCounters>> typeTotals;
+    for (size_t gateId = 0; gateId < gateCounters.size() && gateId < gateTypes.size(); ++gateId) {
+        std::pair<size_t, SGateCounters>& total = typeTotals[gateTypes[gateId]];
+        ++total.first;
+        total.second.drives += gateCounters[gateId].drives;
+        total.second.elided += gateCounters[gateId].elided;
+        total.second.evaluations += gateCounters[gateId].evaluations;
+        total.second.toggles += gateCounters[gateId].toggles;
+        total.second.redundant += gateCounters[gateId].redundant;
+    }
+
+    out << "  \"types\": {";
+    bool first = true;
+    for (const auto& entry : typeTotals) {
+        out << (first ? "\n    " : ",\n    ");
+        CJson::WriteString(out, entry.first);
+        out << ": {\"gates\": " << entry.second.first << ", ";
+        WriteCounters(out, entry.second.second);
+        out << "}";
+        first = false;
+    }
+    out << "\n  },\n  \"gates\": [";
+
+    for (size_t gateId = 0; gateId < gateCounters.size() && gateId < gateNames.size(); ++gateId) {
+        out << (gateId ? ",\n    " : "\n    ") << "{\"name\": ";
+        CJson::WriteString(out, gateNames[gateId]);
+        out << ", \"type\": ";
+        CJson::WriteString(out, gateTypes[gateId]);
+        out << ", ";
+        WriteCounters(out, gateCounters[gateId]);
+        out << "}";
+    }
+    out << "\n  ]\n}" << std::endl;
+#else
+    out << "  \"counters\": \"disabled at build time\"\n}" << std::endl;
+#endif
+}
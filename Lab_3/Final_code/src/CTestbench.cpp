@@ -0,0 +1,154 @@
+#include "CTestbench.h"
+#include <algorithm>
+#include <climits>
+#include <iostream>
+
+// Destructor that frees a process that was never spawned
+CTestbenchProcess::~CTestbenchProcess() {
+    if (handle) {
+        handle.destroy();
+    }
+}
+
+// Constructor that attaches the testbench to a circuit at cycle 0
+CTestbench::CTestbench(Circuit& circuit) : circuit(circuit) {}
+
+// Destructor that frees every process still suspended
+CTestbench::~CTestbench() {
+    for (CTestbenchProcess::Handle process : ready) {
+        process.destroy();
+    }
+    while (!stepWaiters.empty()) {
+        stepWaiters.top().process.destroy();
+        stepWaiters.pop();
+    }
+    for (int gate : watchedGates) {
+        for (const SConditionWaiter& waiter : conditionWaiters[gate]) {
+            waiter.process.destroy();
+        }
+    }
+}
+
+// Returns the net of a named gate; an unknown name is reported and gives a net that is never driven
+STestbenchNet CTestbench::Net(const std::string& gateName) const {
+    STestbenchNet net;
+    net.gate = circuit.FindGate(gateName);
+    if (net.gate < 0) {
+        std::cerr << "Error: Gate " << gateName << " not found." << std::endl;
+    }
+    return net;
+}
+
+// Drives one input of a net's gate; returns false for an unknown net or input
+bool CTestbench::Drive(STestbenchNet net, int inputIndex, eLogicLevel level) {
+    return net.gate >= 0 && circuit.DriveGate(net.gate, inputIndex, level);
+}
+
+// Returns the output level of a net, undefined for an unknown net
+eLogicLevel CTestbench::Read(STestbenchNet net) {
+    return (net.gate >= 0) ? circuit.GetGateOutput(net.gate) : eLogicLevel::LOGIC_UNDEFINED;
+}
+
+// Schedules a process to start in the current round
+void CTestbench::Spawn(CTestbenchProcess process) {
+    if (process.handle) {
+        ready.push_back(process.handle);
+        process.handle = nullptr;
+        ++processCount;
+    }
+}
+
+// Runs rounds and clock cycles until every process has finished or is waiting on a
+// condition no cycle can change, or maxCycles have passed; returns the cycles run.
+// An exception thrown by a process stops the run and is rethrown here.
+uint64_t CTestbench::Run(uint64_t maxCycles) {
+    uint64_t start = cycle;
+    while (true) {
+        RunReady();
+        if (failure) {
+            std::exception_ptr thrown = failure;
+            failure = nullptr;
+            std::rethrow_exception(thrown);
+        }
+        if (WakeConditions()) {
+            continue;                                   // Woken processes run in the same cycle
+        }
+        if (stepWaiters.empty() || cycle - start >= maxCycles) {
+            break;
+        }
+        // Without condition waiters nothing can happen before the next wake, so those cycles run at once
+        uint64_t cycles = watchedGates.empty() ? std::min(stepWaiters.top().wakeCycle - cycle, start + maxCycles - cycle) : 1;
+        cycles = std::min<uint64_t>(cycles, INT_MAX);
+        circuit.Clock(static_cast<int>(cycles));
+        cycle += cycles;
+        while (!stepWaiters.empty() && stepWaiters.top().wakeCycle <= cycle) {
+            ready.push_back(stepWaiters.top().process);
+            stepWaiters.pop();
+        }
+    }
+    return cycle - start;
+}
+
+// Returns true if a condition holds now; a condition on an unknown net never blocks
+bool CTestbench::Holds(const SNetCondition& condition) {
+    return condition.gate < 0 || circuit.GetGateOutput(condition.gate) == condition.level;
+}
+
+// Files a process to be resumed a number of cycles from now
+void CTestbench::WaitCycles(CTestbenchProcess::Handle process, int cycles) {
+    stepWaiters.push(SStepWaiter{cycle + static_cast<uint64_t>(cycles), stepOrder++, process});
+}
+
+// Files a process under the gate its condition watches
+void CTestbench::WaitCondition(CTestbenchProcess::Handle process, const SNetCondition& condition) {
+    if (static_cast<size_t>(condition.gate) >= conditionWaiters.size()) {
+        conditionWaiters.resize(circuit.GetGateCount());
+    }
+    std::vector<SConditionWaiter>& waiters = conditionWaiters[condition.gate];
+    if (waiters.empty()) {
+        watchedGates.push_back(condition.gate);
+    }
+    waiters.push_back(SConditionWaiter{condition.level, process});
+}
+
+// Resumes every ready process, including those made ready meanwhile, and frees finished ones
+void CTestbench::RunReady() {
+    for (size_t next = 0; next < ready.size(); ++next) {
+        CTestbenchProcess::Handle process = ready[next];
+        process.resume();
+        if (process.done()) {
+            if (process.promise().exception && !failure) {
+                failure = process.promise().exception;
+            }
+            process.destroy();
+            --processCount;
+        }
+    }
+    ready.clear();
+}
+
+// Makes ready every process whose net has reached its level, reading each watched gate once;
+// returns true if any process woke
+bool CTestbench::WakeConditions() {
+    bool woke = false;
+    size_t keptGates = 0;
+    for (int gate : watchedGates) {
+        eLogicLevel level = circuit.GetGateOutput(gate);
+        std::vector<SConditionWaiter>& waiters = conditionWaiters[gate];
+        size_t kept = 0;
+        for (const SConditionWaiter& waiter : waiters) {
+            if (waiter.level == level) {
+                ready.push_back(waiter.process);        // Woken in the order they started waiting
+                woke = true;
+            } else {
+                waiters[kept++] = waiter;
+            }
+        }
+        waiters.resize(kept);
+        if (kept > 0) {
+            watchedGates[keptGates++] = gate;
+        }
+    }
+    watchedGates.resize(keptGates);
+    return woke;
+}
@@ -0,0 +1,131 @@
+#include "CTrace.h"
+#include "CJson.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+// The open batch span of the calling thread
+static thread_local const char* batchName = nullptr;
+static thread_local double batchStartUs = 0.0;
+
+// Returns the process-wide trace
+CTrace& CTrace::Instance() {
+    static CTrace trace;
+    return trace;
+}
+
+// Enables tracing; the file is written by Write
+void CTrace::Start(const std::string& path) {
+    outputPath = path;
+    startTime = std::chrono::steady_clock::now();
+    enabled = true;
+    NameThread("main");
+}
+
+// Returns microseconds since tracing started
+double CTrace::Now() const {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+// Records a completed span on the calling thread's lane
+void CTrace::AddSpan(const std::string& name, const char* category, double startUs, double endUs) {
+    std::lock_guard<std::mutex> lock(eventsMutex);
+    events.push_back({name, category, startUs, endUs - startUs, GetLane()});
+}
+
+// Groups consecutive commands of one kind into a single span, closing the
+// previous batch when the kind changes
+void CTrace::SwitchBatch(const char* name) {
+    if (!enabled || (batchName && std::strcmp(batchName, name) == 0)) {
+        return;
+    }
+    double now = Now();
+    if (batchName) {
+        AddSpan(batchName, "batch", batchStartUs, now);
+    }
+    batchName = name;
+    batchStartUs = now;
+}
+
+// Closes the calling thread's open batch span
+void CTrace::EndBatch() {
+    if (enabled && batchName) {
+        AddSpan(batchName, "batch", batchStartUs, Now());
+        batchName = nullptr;
+    }
+}
+
+// Labels the calling thread's lane in the timeline
+void CTrace::NameThread(const std::string& name) {
+    if (!enabled) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(eventsMutex);
+    laneNames[GetLane()] = name;
+}
+
+// Writes every recorded span as trace-event JSON and stops tracing; a later Start begins a
+// new trace. Returns false if the file cannot be written.
+bool CTrace::Write() {
+    if (!enabled) {
+        return true;
+    }
+    EndBatch();
+    std::lock_guard<std::mutex> lock(eventsMutex);
+    enabled = false;
+    std::ofstream out(outputPath);
+    if (!out) {
+        std::cerr << "Error: Cannot write trace file " << outputPath << std::endl;
+        events.clear();  // Dropped, so a later trace starts empty
+        lanes.clear();
+        laneNames.clear();
+        return false;
+    }
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    for (size_t lane = 0; lane < laneNames.size(); ++lane) {
+        out << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << lane 
+            << ", \"args\": {\"name\": ";
+        CJson::WriteString(out, laneNames[lane]);
+        out << "}},\n";
+    }
+    for (size_t event = 0; event < events.size(); ++event) {
+        const SEvent& span = events[event];
+        out << "{\"name\": ";
+        CJson::WriteString(out, span.name);  // Batch spans are named after circuit paths
+        out << ", \"cat\": \"" << span.category << "\", \"ph\": \"X\", \"ts\": " << span.startUs 
+            << ", \"dur\": " << span.durationUs << ", \"pid\": 1, \"tid\": " << span.lane << "}" 
+            << (event + 1 < events.size() ? ",\n" : "\n");
+    }
+    out << "]}" << std::endl;
+    events.clear();
+    lanes.clear();
+    laneNames.clear();
+    if (!out) {
+        std::cerr << "Error: Cannot write trace file " << outputPath << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Returns the lane of the calling thread; eventsMutex must be held
+int CTrace::GetLane() {
+    auto inserted = lanes.emplace(std::this_thread::get_id(), static_cast<int>(laneNames.size()));
+    if (inserted.second) {
+        laneNames.push_back("thread " + std::to_string(inserted.first->second));
+    }
+    return inserted.first->second;
+}
+
+// Starts timing when tracing is enabled
+CTraceSpan::CTraceSpan(const char* name, const char* category) : name(name), category(category) {
+    if (CTrace::Instance().IsEnabled()) {
+        startUs = CTrace::Instance().Now();
+    }
+}
+
+// Records the span if it was started
+CTraceSpan::~CTraceSpan() {
+    if (startUs >= 0.0) {
+        CTrace::Instance().AddSpan(name, category, startUs, CTrace::Instance().Now());
+    }
+}
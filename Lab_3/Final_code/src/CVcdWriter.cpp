@@ -0,0 +1,198 @@
+#include "CVcdWriter.h"
+#include "CAsyncWriter.h"
+#include "Circuit.h"
+#include <algorithm>
+#include <fcntl.h>
+#include <iostream>
+#include <unistd.h>
+
+static const size_t BUFFER_BYTES = 1 << 16;  // Buffered bytes before they go to the writer
+
+// Returns the VCD level character of a logic level
+static char VcdValue(eLogicLevel level) {
+    if (level == eLogicLevel::LOGIC_HIGH) {
+        return '1';
+    } else if (level == eLogicLevel::LOGIC_LOW) {
+        return '0';
+    }
+    return 'x';
+}
+
+// Returns a short printable identifier code for a variable index
+static std::string VcdCode(size_t index) {
+    std::string code;
+    do {
+        code.push_back(static_cast<char>('!' + index % 94));
+        index /= 94;
+    } while (index > 0);
+    return code;
+}
+
+// Constructor that opens the dump file; nets selects gates by name, empty for all
+CVcdWriter::CVcdWriter(const std::string& path, const std::vector<std::string>& nets) : selectedNets(nets) {
+    fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "Error: Cannot write VCD file " << path << std::endl;
+        return;
+    }
+    writer = new CAsyncWriter(fd);  // Large dumps are written while simulation continues
+    buffer.reserve(BUFFER_BYTES);
+}
+
+// Destructor that flushes and closes the file
+CVcdWriter::~CVcdWriter() {
+    Close();
+}
+
+// Returns true when the dump file could be opened
+bool CVcdWriter::IsOpen() const {
+    return writer != nullptr;
+}
+
+// Starts the next simulation step; the first step writes the header
+void CVcdWriter::AdvanceTime(const Circuit& simulated) {
+    if (!writer) {
+        return;
+    }
+    if (!circuit) {
+        Begin(simulated);
+    }
+    ++time;
+    timeWritten = false;
+}
+
+// Moves variables to new gate indices after the netlist was compacted
+void CVcdWriter::Remap(const std::vector<int>& newIds) {
+    std::vector<int> first, count;
+    for (size_t gateId = 0; gateId < newIds.size() && gateId < firstVariable.size(); ++gateId) {
+        if (newIds[gateId] < 0) {
+            continue;
+        }
+        size_t newId = static_cast<size_t>(newIds[gateId]);
+        first.resize(std::max(first.size(), newId + 1), -1);
+        count.resize(first.size(), 0);
+        first[newId] = firstVariable[gateId];
+        count[newId] = variableCount[gateId];
+        for (int variable = 0; variable < variableCount[gateId]; ++variable) {
+            if (firstVariable[gateId] >= 0) {
+                variables[firstVariable[gateId] + variable].gate = static_cast<int>(newId);
+            }
+        }
+    }
+    firstVariable.swap(first);
+    variableCount.swap(count);
+}
+
+// Flushes the buffer and closes the file
+void CVcdWriter::Close() {
+    if (writer) {
+        if (circuit) {
+            Write("#" + std::to_string(time + 1) + "\n");  // Mark the end of the last step
+        }
+        Flush();
+        delete writer;  // Waits for the last write
+        writer = nullptr;
+        close(fd);
+        fd = -1;
+    }
+}
+
+// Declares one variable per dumped output and writes the initial values
+void CVcdWriter::Begin(const Circuit& simulated) {
+    circuit = &simulated;
+    firstVariable.assign(simulated.GetGateCount(), -1);
+    variableCount.assign(simulated.GetGateCount(), 0);
+    std::vector<int> gateIds;
+    if (selectedNets.empty()) {
+        for (int gateId = 0; gateId < simulated.GetGateCount(); ++gateId) {
+            gateIds.push_back(gateId);
+        }
+    }
+    for (const std::string& net : selectedNets) {
+        int gateId = simulated.FindGate(net);
+        if (gateId >= 0) {
+            gateIds.push_back(gateId);
+        } else {
+            std::cerr << "Error: VCD net " << net << " not found." << std::endl;
+        }
+    }
+
+    static const char* comparatorOutputs[] = {"greater", "equal", "less"};
+    Write("$timescale 1ns $end\n$scope module circuit $end\n");
+    for (int gateId : gateIds) {
+        if (firstVariable[gateId] >= 0) {
+            continue;
+        }
+        bool comparator = dynamic_cast<const COneBitComparator*>(simulated.GetGate(gateId)) != nullptr;
+        firstVariable[gateId] = static_cast<int>(variables.size());
+        variableCount[gateId] = comparator ? 3 : 1;
+        for (int output = comparator ? 1 : 0; output <= (comparator ? 3 : 0); ++output) {
+            SVariable variable{gateId, output, VcdCode(variables.size()), 'x'};
+            std::string name = simulated.GetGateName(gateId);
+            if (comparator) {
+                name += "." + std::string(comparatorOutputs[output - 1]);
+            }
+            Write("$var wire 1 " + variable.code + " " + name + " $end\n");
+            variables.push_back(variable);
+        }
+    }
+    Write("$upscope $end\n$enddefinitions $end\n#0\n$dumpvars\n");
+    for (SVariable& variable : variables) {
+        variable.value = ReadValue(variable);
+        Write(std::string(1, variable.value) + variable.code + "\n");
+    }
+    Write("$end\n");
+}
+
+// Writes any output of a gate that differs from its last dumped value
+void CVcdWriter::Record(int gateId) {
+    for (int index = 0; index < variableCount[gateId]; ++index) {
+        SVariable& variable = variables[firstVariable[gateId] + index];
+        char value = ReadValue(variable);
+        if (value == variable.value) {
+            continue;
+        }
+        if (!timeWritten) {
+            Write("#" + std::to_string(time) + "\n");
+            timeWritten = true;
+        }
+        variable.value = value;
+        buffer.push_back(value);
+        buffer += variable.code;
+        buffer.push_back('\n');
+    }
+    if (buffer.size() >= BUFFER_BYTES) {
+        Flush();
+    }
+}
+
+// Reads the current value of a variable from its gate
+char CVcdWriter::ReadValue(const SVariable& variable) const {
+    const CLogicGates* gate = circuit->GetGate(variable.gate);
+    if (variable.output == 0) {
+        return VcdValue(gate->GetOutputState());
+    }
+    const COneBitComparator* comparator = static_cast<const COneBitComparator*>(gate);
+    if (variable.output == 1) {
+        return VcdValue(comparator->GetGreaterOutput());
+    } else if (variable.output == 2) {
+        return VcdValue(comparator->GetEqualOutput());
+    }
+    return VcdValue(comparator->GetLessOutput());
+}
+
+// Appends text to the buffer, writing it out once it is full
+void CVcdWriter::Write(const std::string& text) {
+    buffer += text;
+    if (buffer.size() >= BUFFER_BYTES) {
+        Flush();
+    }
+}
+
+// Hands the buffered text to the writer
+void CVcdWriter::Flush() {
+    if (writer && !buffer.empty()) {
+        writer->sputn(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    }
+    buffer.clear();
+}
@@ -0,0 +1,290 @@
+#include "CVectorStimulus.h"
+#include "CTrace.h"
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+static const size_t CHUNK_BYTES = 1 << 20;    // Bytes read from the stimulus file at a time
+static const size_t BATCH_VECTORS = 64;       // Vectors evaluated per AIG pass
+
+// Constructor that lowers the circuit and picks the observed outputs
+CVectorStimulus::CVectorStimulus(Circuit& circuit) : circuit(circuit) {
+    lowered = circuit.BuildAig(aig, mapping);
+    if (!lowered) {
+        return;  // Run and RunActivity fail; BuildAig has reported why
+    }
+    nodeValues.assign(aig.GetNodeCount(), 0);
+
+    // Start every AIG input from the level currently held by the circuit
+    baseValues.assign(mapping.inputs.size(), 0);
+    for (size_t input = 0; input < mapping.inputs.size(); ++input) {
+        const SAigMapping::SPin& pin = mapping.inputs[input];
+        const CLogicGates* gate = circuit.GetGate(pin.gate);
+        eLogicLevel level = (pin.inputIndex < 0) ? gate->GetOutputState() : gate->GetInput(pin.inputIndex);
+        baseValues[input] = (level == eLogicLevel::LOGIC_HIGH) ? ~0ull : 0ull;
+    }
+    for (size_t input = 0; input < mapping.inputs.size(); ++input) {
+        if (mapping.inputs[input].inputIndex >= 0) {
+            columns.push_back(static_cast<int>(input));  // Without a header every free input is a column
+        }
+    }
+
+    SelectOutputs(circuit.GetOutputGates().empty());
+}
+
+// Picks the outputs to evaluate: the observed gates, or every gate
+void CVectorStimulus::SelectOutputs(bool allGates) {
+    std::vector<int> observed;
+    if (allGates) {
+        for (int gateId = 0; gateId < circuit.GetGateCount(); ++gateId) {
+            observed.push_back(gateId);
+        }
+    } else {
+        for (const std::string& gateName : circuit.GetOutputGates()) {
+            observed.push_back(circuit.FindGate(gateName));
+        }
+    }
+    outputLiterals.clear();
+    outputNames.clear();
+    static const char* comparatorOutputs[] = {"greater", "equal", "less"};
+    for (int gateId : observed) {
+        if (gateId < 0) {
+            continue;
+        }
+        const std::vector<uint32_t>& literals = mapping.gateOutputs[gateId];
+        for (size_t output = 0; output < literals.size(); ++output) {
+            outputLiterals.push_back(literals[output]);
+            outputNames.push_back((literals.size() == 3) 
+                ? circuit.GetGateName(gateId) + "." + comparatorOutputs[output] : circuit.GetGateName(gateId));
+        }
+    }
+    outputWords.resize(outputLiterals.size());
+}
+
+// Returns the number of vectors simulated by the last run
+size_t CVectorStimulus::GetVectorCount() const {
+    return vectorCount;
+}
+
+// Writes the output names and one output record per vector of the stimulus file
+bool CVectorStimulus::Run(const std::string& path, std::ostream& out) {
+    if (!lowered) {
+        return false;
+    }
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        circuit.GetErrorStream() << "Error: Cannot open stimulus file " << path << std::endl;
+        return false;
+    }
+    out << "outputs";
+    for (const std::string& outputName : outputNames) {
+        out << " " << outputName;
+    }
+    out << "\n";
+    return Stream(file, out);
+}
+
+// Counts the toggles of every gate output over the stimulus file and reports
+// them per gate and in total; activity is toggles per vector transition
+bool CVectorStimulus::RunActivity(const std::string& path, std::ostream& report) {
+    if (!lowered) {
+        return false;
+    }
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        circuit.GetErrorStream() << "Error: Cannot open stimulus file " << path << std::endl;
+        return false;
+    }
+    countToggles = true;
+    SelectOutputs(true);
+    toggleCounts.assign(outputLiterals.size(), 0);
+    lastBits.assign(outputLiterals.size(), 0);
+    if (!Stream(file, report)) {
+        return false;
+    }
+
+    double perTransition = (vectorCount > 1) ? 1.0 / (vectorCount - 1) : 0.0;
+    uint64_t totalToggles = 0;
+    for (size_t output = 0; output < outputNames.size(); ++output) {
+        report << "Gate " << outputNames[output] << " toggles: " << toggleCounts[output] 
+               << " activity: " << toggleCounts[output] * perTransition << "\n";
+        totalToggles += toggleCounts[output];
+    }
+    double average = outputNames.empty() ? 0.0 : totalToggles * perTransition / outputNames.size();
+    report << "Activity: " << vectorCount << " vectors, " << totalToggles 
+           << " toggles, " << average << " average per output";
+    return true;
+}
+
+// Streams the stimulus in large chunks through the bit-parallel engine
+bool CVectorStimulus::Stream(std::istream& file, std::ostream& out) {
+    columnWords.assign(columns.size(), 0);
+    batchSize = 0;
+    vectorCount = 0;
+    std::vector<char> chunk(CHUNK_BYTES);
+    std::string line;
+    size_t lineNumber = 0;
+    while (file) {
+        CTraceSpan span("VectorChunk", "stimulus");
+        file.read(chunk.data(), chunk.size());
+        std::streamsize bytes = file.gcount();
+        for (std::streamsize index = 0; index < bytes; ++index) {
+            if (chunk[index] != '\n') {
+                line.push_back(chunk[index]);
+                continue;
+            }
+            ++lineNumber;
+            if (!ParseVector(line, lineNumber)) {
+                return false;
+            }
+            line.clear();
+        }
+        out.write(records.data(), records.size());
+        records.clear();
+    }
+    if (!line.empty() && !ParseVector(line, lineNumber + 1)) {
+        return false;
+    }
+    if (batchSize > 0) {
+        EvaluateBatch();
+    }
+    out.write(records.data(), records.size());
+    records.clear();
+    return true;
+}
+
+// Maps the header's gate.index names onto AIG inputs
+bool CVectorStimulus::ParseHeader(const std::string& line) {
+    std::istringstream header(line);
+    std::string keyword, pinName;
+    header >> keyword;
+    columns.clear();
+    while (header >> pinName) {
+        size_t dot = pinName.rfind('.');
+        int gateId = (dot == std::string::npos) ? -1 : circuit.FindGate(pinName.substr(0, dot));
+        int inputIndex = (dot == std::string::npos) ? -1 : std::atoi(pinName.c_str() + dot + 1);
+        int column = -1;
+        for (size_t input = 0; input < mapping.inputs.size(); ++input) {
+            if (mapping.inputs[input].gate == gateId && mapping.inputs[input].inputIndex == inputIndex) {
+                column = static_cast<int>(input);
+            }
+        }
+        if (column < 0) {
+            circuit.GetErrorStream() << "Error: " << pinName << " is not a free gate input." << std::endl;
+            return false;
+        }
+        columns.push_back(column);
+    }
+    columnWords.assign(columns.size(), 0);
+    return true;
+}
+
+// Parses one line, adding its vector to the current batch
+bool CVectorStimulus::ParseVector(const std::string& line, size_t lineNumber) {
+    std::string text = line.substr(0, line.find('#'));
+    size_t first = text.find_first_not_of(" \t\r");
+    if (first == std::string::npos) {
+        return true;  // Blank or comment line
+    }
+    text = text.substr(first, text.find_last_not_of(" \t\r") - first + 1);
+    if (text.compare(0, 6, "inputs") == 0) {
+        if (vectorCount > 0 || batchSize > 0) {
+            circuit.GetErrorStream() << "Error: Stimulus header on line " << lineNumber << " follows vectors." << std::endl;
+            return false;
+        }
+        return ParseHeader(text);
+    }
+
+    uint64_t mask = 1ull << batchSize;
+    size_t width = columns.size();
+    if (text.size() > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+        bool valid = text.size() - 2 <= (width + 3) / 4;  // No more digits than the inputs need
+        size_t bit = 0;  // Bits counted from the least significant end, i.e. the last column
+        for (size_t index = text.size(); valid && index-- > 2;) {
+            unsigned char c = static_cast<unsigned char>(text[index]);
+            if (!std::isxdigit(c)) {
+                valid = false;
+                break;
+            }
+            int digit = std::isdigit(c) ? c - '0' : std::tolower(c) - 'a' + 10;
+            for (int nibbleBit = 0; nibbleBit < 4; ++nibbleBit, ++bit) {
+                if (((digit >> nibbleBit) & 1) && bit >= width) {
+                    valid = false;  // A set bit above the first input
+                } else if ((digit >> nibbleBit) & 1) {
+                    columnWords[width - 1 - bit] |= mask;
+                }
+            }
+        }
+        if (!valid) {
+            circuit.GetErrorStream() << "Error: Line " << lineNumber << " is not a " << width 
+                      << "-bit hex vector." << std::endl;
+            return false;
+        }
+    } else if (text.size() == width && text.find_first_not_of("01") == std::string::npos) {
+        for (size_t column = 0; column < width; ++column) {
+            if (text[column] == '1') {
+                columnWords[column] |= mask;
+            }
+        }
+    } else {
+        circuit.GetErrorStream() << "Error: Line " << lineNumber << " is not a " << width 
+                  << "-bit vector." << std::endl;
+        return false;
+    }
+
+    ++vectorCount;
+    if (++batchSize == BATCH_VECTORS) {
+        EvaluateBatch();
+    }
+    return true;
+}
+
+// Evaluates the batched vectors in one AIG pass and formats their records
+void CVectorStimulus::EvaluateBatch() {
+    for (size_t input = 0; input < baseValues.size(); ++input) {
+        nodeValues[1 + input] = baseValues[input];
+    }
+    for (size_t column = 0; column < columns.size(); ++column) {
+        nodeValues[1 + columns[column]] = columnWords[column];
+        columnWords[column] = 0;
+    }
+    aig.Simulate(nodeValues);
+
+    size_t width = outputLiterals.size();
+    for (size_t output = 0; output < width; ++output) {
+        outputWords[output] = CAig::GetLiteralValue(nodeValues, outputLiterals[output]);
+    }
+    if (countToggles) {
+        CountToggles();
+        return;
+    }
+    size_t start = records.size();
+    records.resize(start + batchSize * (width + 1));
+    char* record = &records[start];
+    for (size_t vector = 0; vector < batchSize; ++vector) {
+        for (size_t output = 0; output < width; ++output) {
+            *record++ = ((outputWords[output] >> vector) & 1) ? '1' : '0';
+        }
+        *record++ = '\n';
+    }
+    batchSize = 0;
+}
+
+// Adds the toggles of the batched vectors: shifting each output word up by one
+// lines every vector up with its predecessor, so XOR and popcount give the
+// transitions of the whole batch at once
+void CVectorStimulus::CountToggles() {
+    uint64_t valid = (batchSize == BATCH_VECTORS) ? ~0ull : (1ull << batchSize) - 1;
+    if (vectorCount == batchSize) {
+        valid &= ~1ull;  // The first vector has no predecessor
+    }
+    for (size_t output = 0; output < outputWords.size(); ++output) {
+        uint64_t word = outputWords[output];
+        uint64_t previous = (word << 1) | lastBits[output];
+        toggleCounts[output] += __builtin_popcountll((word ^ previous) & valid);
+        lastBits[output] = (word >> (batchSize - 1)) & 1;
+    }
+    batchSize = 0;
+}
@@ -1,8 +1,9 @@
 #include "CXORGate.h"
+#include "CAig.h"
 
-// Constructor to initialize XOR gate with two undefined inputs
-CXORGates::CXORGates() {
-    inputs.resize(2, eLogicLevel::LOGIC_UNDEFINED);
+// Constructor to initialize XOR gate (XNOR when inverted) with undefined inputs
+CXORGates::CXORGates(int inputCount, bool inverted) : inverted(inverted) {
+    SetInputCount(inputCount);
 }
 
 // Sets the logic level of a specific input and recomputes the output
@@ -16,7 +17,36 @@ eLogicLevel CXORGates::GetOutputState() const {
     return outputValue;
 }
 
-// Computes the XOR gate's output based on its two inputs
+// Returns a copy of the gate including its current input and output levels
+CLogicGates* CXORGates::Clone() const {
+    return new CXORGates(*this);
+}
+
+// Returns the bytes the gate occupies; its inputs are stored inline
+size_t CXORGates::GetMemoryBytes() const {
+    return sizeof(*this) + GetInputHeapBytes();
+}
+
+// Computes the XOR gate's output. Two inputs are high when they differ; wider
+// gates take the parity of their high inputs as a vectorizable reduction.
 void CXORGates::ComputeOutput() {
-    outputValue = (inputs[0] != inputs[1]) ? eLogicLevel::LOGIC_HIGH : eLogicLevel::LOGIC_LOW;
+    bool parity = false;
+    if (inputCount == 2) {
+        parity = (inputs[0] != inputs[1]);
+    } else {
+        for (int inputIndex = 0; inputIndex < inputCount; ++inputIndex) {
+            parity ^= (inputs[inputIndex] == eLogicLevel::LOGIC_HIGH);
+        }
+    }
+    outputValue = (parity != inverted) ? eLogicLevel::LOGIC_HIGH : eLogicLevel::LOGIC_LOW;
+}
+
+// Lowers the XOR gate into the AND-inverter graph
+void CXORGates::LowerToAig(CAig& aig, const std::vector<uint32_t>& inputLiterals,
+                           std::vector<uint32_t>& outputLiterals) const {
+    uint32_t literal = inputLiterals[0];
+    for (size_t input = 1; input < inputLiterals.size(); ++input) {
+        literal = aig.AddXor(literal, inputLiterals[input]);
+    }
+    outputLiterals.assign(1, inverted ? CAig::Not(literal) : literal);
 }
@@ -1,68 +1,712 @@
 #include "Circuit.h"
+#include "CCheckpoint.h"
+#include "CGateRegistry.h"
+#include "CNetlistOptimizer.h"
+#include "CTrace.h"
+#include "CVcdWriter.h"
+#include <algorithm>
 #include <iostream>
 
-// Adds a gate to the circuit based on the gate type and assigns it a name
-void Circuit::AddGate(const std::string& gateType, const std::string& gateName) {
-    if (gateType == "AND") {
-        gates[gateName] = new CAndGates();          // Add AND gate
-    } else if (gateType == "XOR") {
-        gates[gateName] = new CXORGates();          // Add XOR gate
-    } else if (gateType == "OR") {
-        gates[gateName] = new COrGates();           // Add OR gate
-    } else if (gateType == "NOT") {
-        gates[gateName] = new CNotGate();           // Add NOT gate
-    } else if (gateType == "1BitComparator") {
-        gates[gateName] = new COneBitComparator();  // Add 1-bit comparator
-    } else {
-        std::cerr << "Error: Unknown gate type " 
-        << gateType << std::endl;                   // Error for unknown gate type
+// Copies the netlist and its current logic levels; the copy has no waveform dump
+// and reports errors to std::cerr
+Circuit::Circuit(const Circuit& other) 
+    : gateIds(other.gateIds), gateNames(other.gateNames), gateTypeIds(other.gateTypeIds), 
+      fanouts(other.fanouts), fanins(other.fanins), tiedInputs(other.tiedInputs), 
+      registers(other.registers), evalOrder(other.evalOrder), levelsDirty(other.levelsDirty), 
+      lazyEvaluation(other.lazyEvaluation), dirty(other.dirty), conePruning(other.conePruning), 
+      pruned(other.pruned), outputGates(other.outputGates), 
+      stats(other.stats) {
+    gates.reserve(other.gates.size());
+    for (const CLogicGates* gate : other.gates) {
+        gates.push_back(gate->Clone());
     }
 }
 
-// Drives the input of a specified gate with a given logic level
-void Circuit::DriveGate(const std::string& gateName, int inputIndex, eLogicLevel level) {
-    if (gates.find(gateName) != gates.end()) {
-        std::cout << "Input Index " << inputIndex 
-        << " of " << gateName << " gate runs with logic " 
-                  << static_cast<int>(level) << std::endl;  // Output driven input
-        gates[gateName]->DriveInput(inputIndex, level);     // Drive the input of the gate
-    } else {
-        std::cerr << "Error: Gate " 
+// Releases the gates owned by the circuit
+Circuit::~Circuit() {
+    for (CLogicGates* gate : gates) {
+        delete gate;
+    }
+}
+
+// Adds a gate of a registered type to the circuit and assigns it a name. The
+// input count applies to variable fan-in kinds; 0 means the kind's default.
+// Returns the new gate's id, or -1 if the gate could not be added.
+int Circuit::AddGate(const std::string& gateType, const std::string& gateName, int inputCount) {
+    const CGateRegistry& registry = CGateRegistry::Instance();
+    int typeId = registry.FindType(gateType);
+    if (typeId < 0) {
+        *errors << "Error: Unknown gate type " 
+        << gateType << std::endl;        // Error for unknown gate type
+        return -1;
+    }
+    if (!registry.AcceptsInputCount(typeId, inputCount)) {
+        *errors << "Error: Gate " << gateName 
+        << " cannot have " << inputCount << " inputs." << std::endl;  // Error for unsupported fan-in
+        return -1;
+    }
+    int gateId = static_cast<int>(gates.size());
+    if (!gateIds.emplace(gateName, gateId).second) {
+        *errors << "Error: Gate " 
+        << gateName << " already exists." << std::endl;  // Error for duplicate gate name
+        return -1;
+    }
+
+    CLogicGates* gate = registry.Create(typeId, inputCount);
+    if (gate->IsSequential()) {
+        registers.push_back(gateId);
+    }
+    gates.push_back(gate);
+    gateNames.push_back(gateName);
+    gateTypeIds.push_back(static_cast<uint16_t>(typeId));
+    fanouts.emplace_back();
+    dirty.push_back(false);
+    pruned.push_back(false);  // New gates are simulated until pruning runs again
+    stats.AddGate();
+    tiedInputs.emplace_back(gate->GetInputCount(), eLogicLevel::LOGIC_UNDEFINED);
+    levelsDirty = true;
+    return gateId;
+}
+
+// Returns true if AddGate accepts the gate type with the given input count
+bool Circuit::IsKnownGateType(const std::string& gateType, int inputCount) {
+    const CGateRegistry& registry = CGateRegistry::Instance();
+    int typeId = registry.FindType(gateType);
+    return typeId >= 0 && registry.AcceptsInputCount(typeId, inputCount);
+}
+
+// Adds a register as a bank of D flip-flops named name[0] .. name[width-1]
+void Circuit::AddRegister(const std::string& registerName, int width) {
+    for (int bit = 0; bit < width; ++bit) {
+        AddGate("DFF", registerName + "[" + std::to_string(bit) + "]");
+    }
+}
+
+// Connects the output of the source gate to an input of the target gate
+void Circuit::ConnectGates(const std::string& sourceName, const std::string& targetName, int inputIndex) {
+    int source = FindGate(sourceName);
+    int target = FindGate(targetName);
+    if (source < 0 || target < 0) {
+        *errors << "Error: Cannot connect " << sourceName 
+        << " to " << targetName << ", gate not found." << std::endl;  // Error if either gate not found
+        return;
+    }
+    if (inputIndex < 0 || inputIndex >= gates[target]->GetInputCount()) {
+        *errors << "Error: Gate " << targetName 
+        << " has no input " << inputIndex << "." << std::endl;       // Error for invalid input index
+        return;
+    }
+
+    fanouts[source].push_back({target, inputIndex});
+    levelsDirty = true;
+    if (pruned[source] && !pruned[target]) {
+        Levelize();
+        std::vector<bool> inCone(pruned);
+        inCone.flip();
+        MarkCone({source}, inCone);             // The new driver now reaches an observed output
+        ApplyCone(inCone);
+    }
+
+    // A source that has already been driven hands its level to the new input
+    eLogicLevel level = gates[source]->GetOutputState();
+    if (lazyEvaluation && !gates[target]->IsSequential()) {
+        if (dirty[source] || level != eLogicLevel::LOGIC_UNDEFINED) {
+            MarkDirty(target);
+        }
+    } else if (level != eLogicLevel::LOGIC_UNDEFINED && ApplyInput(target, inputIndex, level)) {
+        Propagate(target);
+    }
+}
+
+// Ties an input of a gate to a constant level that the optimizer may fold
+void Circuit::TieInput(const std::string& gateName, int inputIndex, eLogicLevel level) {
+    int gateId = FindGate(gateName);
+    if (gateId < 0 || inputIndex < 0 || inputIndex >= gates[gateId]->GetInputCount()
+        || level == eLogicLevel::LOGIC_UNDEFINED) {
+        *errors << "Error: Cannot tie input " << inputIndex 
+        << " of " << gateName << "." << std::endl;     // Error for unknown gate, input or level
+        return;
+    }
+
+    tiedInputs[gateId][inputIndex] = level;
+    if (ApplyInput(gateId, inputIndex, level)) {
+        Propagate(gateId);
+    }
+}
+
+// Drives the input of a specified gate with a given logic level; returns false
+// if the gate or input does not exist
+bool Circuit::DriveGate(const std::string& gateName, int inputIndex, eLogicLevel level) {
+    int gateId = FindGate(gateName);
+    if (gateId < 0) {
+        *errors << "Error: Gate " 
         << gateName << " not found." << std::endl;          // Error if gate not found
+        return false;
+    }
+    return DriveGate(gateId, inputIndex, level);
+}
+
+// Drives the input of the gate with the given index
+bool Circuit::DriveGate(int gateId, int inputIndex, eLogicLevel level) {
+    if (inputIndex < 0 || inputIndex >= gates[gateId]->GetInputCount()) {
+        *errors << "Error: Gate " << gateNames[gateId] 
+        << " has no input " << inputIndex << "." << std::endl;  // Error for invalid input index
+        return false;
+    }
+    if (vcdWriter) {
+        vcdWriter->AdvanceTime(*this);                      // Each drive is one dump time step
+    }
+    if (lazyEvaluation && !gates[gateId]->IsSequential()) {
+        if (gates[gateId]->Holds(inputIndex, level)) {
+            SIM_STATS(stats.RecordElidedDrive(gateId));     // Neither the gate nor its fan-out goes stale
+            return true;
+        }
+        gates[gateId]->SetInput(inputIndex, level);         // Evaluated when an output is queried
+        SIM_STATS(stats.RecordDrive(gateId));
+        MarkDirty(gateId);
+        return true;
+    }
+    if (ApplyInput(gateId, inputIndex, level)) {            // Drive the input of the gate
+        Propagate(gateId);                                  // Forward the change to connected gates
+    }
+    return true;
+}
+
+// Runs the circuit for a number of clock cycles: each cycle evaluates the
+// combinational logic once in level order and then latches every register
+void Circuit::Clock(int cycles) {
+    if (levelsDirty) {
+        Levelize();
+    }
+    SettleDirty();
+    for (int cycle = 0; cycle < cycles; ++cycle) {
+        if (vcdWriter) {
+            vcdWriter->AdvanceTime(*this);                  // Each cycle is one dump time step
+        }
+        EvaluateLevels();
+        for (int gateId : registers) {
+            if (pruned[gateId]) {
+                continue;
+            }
+            CDFlipFlop* flipFlop = static_cast<CDFlipFlop*>(gates[gateId]);
+            SIM_STATS(eLogicLevel previous = flipFlop->GetOutputState());
+            flipFlop->Latch();                              // All registers capture D together
+            SIM_STATS(stats.RecordEvaluation(gateId, true, flipFlop->GetOutputState() != previous));
+            if (vcdWriter) {
+                vcdWriter->Sample(gateId);
+            }
+        }
+    }
+    EvaluateLevels();                                       // Settle logic on the new register state
+}
+
+// Switches between evaluating on every drive and evaluating only when an output is
+// queried; leaving lazy mode brings every stale gate up to date
+void Circuit::SetLazyEvaluation(bool enabled) {
+    if (lazyEvaluation && !enabled) {
+        SettleDirty();
     }
+    lazyEvaluation = enabled;
+    dirty.assign(gates.size(), false);
+}
+
+// Restricts simulation to the fan-in cone of the observed outputs, or lifts the
+// restriction; gates leaving the cone keep their last levels and gates rejoining
+// it are brought up to date. Returns the number of gates kept.
+int Circuit::SetConePruning(bool enabled) {
+    if (enabled && outputGates.empty()) {
+        *errors << "Error: No observed outputs to prune to." << std::endl;
+        enabled = false;
+    }
+    if (levelsDirty) {
+        Levelize();
+    }
+    std::vector<bool> inCone(gates.size(), !enabled);
+    if (enabled) {
+        std::vector<int> roots;
+        for (const std::string& gateName : outputGates) {
+            int gateId = FindGate(gateName);
+            if (gateId >= 0) {
+                roots.push_back(gateId);
+            }
+        }
+        MarkCone(roots, inCone);
+    }
+    conePruning = enabled;
+    ApplyCone(inCone);
+    return static_cast<int>(std::count(inCone.begin(), inCone.end(), true));
+}
+
+// Brings every gate up to date, so the whole state can be read directly
+void Circuit::Settle() {
+    SettleDirty();
 }
 
 // Returns the output state of a specified gate
-eLogicLevel Circuit::GetGateOutput(const std::string& gateName) const {
-    if (gates.find(gateName) != gates.end()) {
-        return gates.at(gateName)->GetOutputState();  // Return output state of the gate
+eLogicLevel Circuit::GetGateOutput(const std::string& gateName) {
+    int gateId = FindGate(gateName);
+    if (gateId >= 0) {
+        return GetGateOutput(gateId);                   // Return output state of the gate
     } else {
-        std::cerr << "Error: Gate " 
+        *errors << "Error: Gate " 
         << gateName << " not found." << std::endl;      // Error if gate not found
         return eLogicLevel::LOGIC_UNDEFINED;            // Return undefined logic level if gate not found
     }
 }
 
+// Returns the output state of the gate with the given index; a gate pruned
+// from simulation reads as undefined
+eLogicLevel Circuit::GetGateOutput(int gateId) {
+    if (pruned[gateId]) {
+        return eLogicLevel::LOGIC_UNDEFINED;
+    }
+    if (lazyEvaluation && dirty[gateId]) {
+        EvaluateCone(gateId);                           // Bring the queried fan-in cone up to date
+    }
+    return gates[gateId]->GetOutputState();
+}
+
 // Returns the output of a one-bit comparator based on the output type (greater, equal, less)
-eLogicLevel Circuit::GetComparatorOutput(const std::string& gateName, const std::string& outputType) const {
-    if (gates.find(gateName) != gates.end()) {
-        COneBitComparator* comparator = dynamic_cast<COneBitComparator*>(gates.at(gateName));  // Cast to comparator
-        if (comparator) {
-            if (outputType == "greater") {
-                return comparator->GetGreaterOutput();  // Return output for greater
-            } else if (outputType == "equal") {
-                return comparator->GetEqualOutput();    // Return output for equal
-            } else if (outputType == "less") {
-                return comparator->GetLessOutput();     // Return output for less
-            }
-        }
+eLogicLevel Circuit::GetComparatorOutput(const std::string& gateName, const std::string& outputType) {
+    int gateId = FindGate(gateName);
+    if (gateId >= 0) {
+        return GetComparatorOutput(gateId, outputType);
     }
-    std::cerr << "Error: Gate " << gateName 
+    *errors << "Error: Gate " << gateName 
     << " not found or not a comparator." << std::endl;  // Error for invalid gate or comparator
     return eLogicLevel::LOGIC_UNDEFINED;                // Return undefined logic level if gate or comparator not found
 }
 
+// Returns one output of the comparator with the given index
+eLogicLevel Circuit::GetComparatorOutput(int gateId, const std::string& outputType) {
+    if (pruned[gateId]) {
+        return eLogicLevel::LOGIC_UNDEFINED;
+    }
+    if (lazyEvaluation && dirty[gateId]) {
+        EvaluateCone(gateId);                           // Bring the queried fan-in cone up to date
+    }
+    COneBitComparator* comparator = dynamic_cast<COneBitComparator*>(gates[gateId]);  // Cast to comparator
+    if (comparator) {
+        if (outputType == "greater") {
+            return comparator->GetGreaterOutput();      // Return output for greater
+        } else if (outputType == "equal") {
+            return comparator->GetEqualOutput();        // Return output for equal
+        } else if (outputType == "less") {
+            return comparator->GetLessOutput();         // Return output for less
+        }
+    }
+    *errors << "Error: Gate " << gateNames[gateId] 
+    << " not found or not a comparator." << std::endl;  // Error for invalid gate or comparator
+    return eLogicLevel::LOGIC_UNDEFINED;
+}
+
 // Adds a gate to the list of output gates
 void Circuit::AddOutputGate(const std::string& gateName) {
     outputGates.push_back(gateName);                    // Add gate name to outputGates vector
+    int gateId = FindGate(gateName);
+    if (conePruning && gateId >= 0 && pruned[gateId]) {
+        SetConePruning(true);                           // Widen the cone to the new output
+    }
+}
+
+// Simplifies the netlist before simulation and returns the number of gates removed
+int Circuit::Optimize() {
+    CTraceSpan span("Optimize", "compile");
+    SettleDirty();
+    bool pruning = conePruning;
+    if (pruning) {
+        SetConePruning(false);                          // The optimizer renumbers gates
+    }
+    CNetlistOptimizer optimizer(*this);
+    int removedCount = optimizer.Run();
+    if (pruning) {
+        SetConePruning(true);
+    }
+    return removedCount;
+}
+
+// Saves the level of every gate input and output to a checkpoint image
+bool Circuit::SaveCheckpoint(const std::string& path) {
+    CCheckpoint checkpoint(*this);
+    return checkpoint.Save(path);
+}
+
+// Restores gate levels from a checkpoint image saved from the same netlist
+bool Circuit::RestoreCheckpoint(const std::string& path) {
+    CCheckpoint checkpoint(*this);
+    return checkpoint.Restore(path);
+}
+
+// Lowers the whole circuit into an AND-inverter graph. Unconnected, untied gate
+// inputs and register outputs become AIG inputs; gates are lowered in level order.
+// Returns false if a comparator drives another gate, since the level it hands on
+// is undefined in the reference engine and has no AIG literal.
+bool Circuit::BuildAig(CAig& aig, SAigMapping& mapping) {
+    CTraceSpan span("BuildAig", "compile");
+    if (levelsDirty) {
+        Levelize();
+    }
+
+    mapping.inputs.clear();
+    mapping.gateInputs.assign(gates.size(), {});
+    mapping.gateOutputs.assign(gates.size(), {});
+    for (size_t gateId = 0; gateId < gates.size(); ++gateId) {
+        int gate = static_cast<int>(gateId);
+        mapping.gateInputs[gateId].assign(gates[gateId]->GetInputCount(), CAig::LITERAL_FALSE);
+        for (int input = 0; input < gates[gateId]->GetInputCount(); ++input) {
+            if (tiedInputs[gateId][input] != eLogicLevel::LOGIC_UNDEFINED) {
+                mapping.gateInputs[gateId][input] = (tiedInputs[gateId][input] == eLogicLevel::LOGIC_HIGH)
+                    ? CAig::LITERAL_TRUE : CAig::LITERAL_FALSE;
+            } else if (fanins[gateId][input] < 0) {
+                mapping.gateInputs[gateId][input] = aig.AddInput();  // Driven by stimulus
+                mapping.inputs.push_back({gate, input});
+            }
+        }
+        if (gates[gateId]->IsSequential()) {
+            mapping.gateOutputs[gateId].assign(1, aig.AddInput());  // Register state
+            mapping.inputs.push_back({gate, -1});
+        }
+    }
+
+    for (int gateId : evalOrder) {
+        if (!gates[gateId]->IsSequential()) {
+            gates[gateId]->LowerToAig(aig, mapping.gateInputs[gateId], mapping.gateOutputs[gateId]);
+        }
+        uint32_t literal = mapping.gateOutputs[gateId].empty() ? CAig::LITERAL_FALSE : mapping.gateOutputs[gateId][0];
+        for (const SConnection& connection : fanouts[gateId]) {
+            if (tiedInputs[connection.gate][connection.inputIndex] != eLogicLevel::LOGIC_UNDEFINED) {
+                continue;
+            }
+            if (mapping.gateOutputs[gateId].size() > 1) {
+                // A gate with several outputs hands on an undefined level, which the AIG cannot represent
+                *errors << "Error: " << GetGateType(gateId) << " " << gateNames[gateId] << " drives gate " 
+                          << gateNames[connection.gate] << ", so the circuit cannot be lowered to an AIG." << std::endl;
+                return false;
+            }
+            mapping.gateInputs[connection.gate][connection.inputIndex] = literal;
+        }
+    }
+    return true;
+}
+
+// Returns the activity counters and phase timers of this circuit
+CSimStats& Circuit::GetStats() {
+    return stats;
+}
+
+// Writes the collected statistics as JSON
+void Circuit::WriteStats(std::ostream& out) {
+    std::vector<std::string> gateTypes;
+    gateTypes.reserve(gates.size());
+    for (size_t gateId = 0; gateId < gates.size(); ++gateId) {
+        gateTypes.push_back(GetGateType(gateId));
+    }
+    stats.WriteJson(out, gateNames, gateTypes);
+}
+
+// Returns the heap bytes held by a string beyond its inline buffer
+static size_t StringHeapBytes(const std::string& text) {
+    return (text.capacity() > 15) ? text.capacity() + 1 : 0;
+}
+
+// The gate layout before inputs were stored inline: a vtable, a vector of int-sized
+// levels on the heap and an int-sized output
+struct SVectorGate {
+    virtual ~SVectorGate() = default;
+    std::vector<int> inputs;
+    int outputValue;
+};
+
+// Writes how much memory the gates and the netlist around them occupy, and what the
+// gates would take in the vector-backed layout
+void Circuit::WriteMemoryReport(std::ostream& out) const {
+    size_t gateBytes = 0;
+    size_t vectorGateBytes = 0;
+    for (const CLogicGates* gate : gates) {
+        gateBytes += gate->GetMemoryBytes() + sizeof(CLogicGates*);
+        vectorGateBytes += sizeof(SVectorGate) + gate->GetInputCount() * sizeof(int) + sizeof(CLogicGates*);
+    }
+    size_t netlistBytes = gateNames.capacity() * sizeof(std::string) + gateTypeIds.capacity() * sizeof(uint16_t) 
+                        + fanouts.capacity() * sizeof(fanouts[0]) + fanins.capacity() * sizeof(fanins[0]) 
+                        + tiedInputs.capacity() * sizeof(tiedInputs[0]) + (dirty.capacity() + pruned.capacity()) / 8 
+                        + gateIds.bucket_count() * sizeof(void*) 
+                        + gateIds.size() * (sizeof(std::pair<const std::string, int>) + sizeof(void*));
+    for (size_t gateId = 0; gateId < gates.size(); ++gateId) {
+        netlistBytes += StringHeapBytes(gateNames[gateId]) 
+                      + fanouts[gateId].capacity() * sizeof(SConnection) 
+                      + tiedInputs[gateId].capacity() * sizeof(eLogicLevel);
+        if (gateId < fanins.size()) {
+            netlistBytes += fanins[gateId].capacity() * sizeof(int);
+        }
+    }
+    for (const auto& entry : gateIds) {
+        netlistBytes += StringHeapBytes(entry.first);
+    }
+
+    double perGate = gates.empty() ? 0.0 : 1.0 / gates.size();
+    out << "Memory: " << gates.size() << " gates, " << gateBytes << " bytes in gates (" 
+        << gateBytes * perGate << " per gate), " << netlistBytes << " bytes of netlist (" 
+        << netlistBytes * perGate << " per gate); vector-backed gates would take " << vectorGateBytes 
+        << " bytes (" << vectorGateBytes * perGate << " per gate)";
+}
+
+// Attaches a VCD writer that records every output change, or detaches it with nullptr
+void Circuit::SetVcdWriter(CVcdWriter* writer) {
+    vcdWriter = writer;
+}
+
+// Returns the number of gates in the circuit
+int Circuit::GetGateCount() const {
+    return static_cast<int>(gates.size());
+}
+
+// Returns a gate by index for read-only inspection
+const CLogicGates* Circuit::GetGate(int gateId) const {
+    return gates[gateId];
+}
+
+// Returns the name of a gate by index
+const std::string& Circuit::GetGateName(int gateId) const {
+    return gateNames[gateId];
+}
+
+// Returns the registered type name of the gate with the given index
+const std::string& Circuit::GetGateType(int gateId) const {
+    return CGateRegistry::Instance().GetName(gateTypeIds[gateId]);
+}
+
+// Returns the names of the gates marked for output
+const std::vector<std::string>& Circuit::GetOutputGates() const {
+    return outputGates;
+}
+
+// Drives one gate input and records the activity; returns true when the output changed.
+// A drive that repeats the level of an evaluated gate's input is skipped.
+bool Circuit::ApplyInput(int gateId, int inputIndex, eLogicLevel level) {
+    CLogicGates* gate = gates[gateId];
+    if (pruned[gateId]) {
+        gate->SetInput(inputIndex, level);              // Kept for when the gate rejoins the cone
+        return false;
+    }
+    if (gate->Holds(inputIndex, level)) {
+        SIM_STATS(stats.RecordElidedDrive(gateId));
+        return false;
+    }
+    eLogicLevel previous = gate->GetOutputState();
+    gate->Drive(inputIndex, level);
+    bool changed = gate->GetOutputState() != previous;
+    SIM_STATS(stats.RecordDrive(gateId));
+    SIM_STATS(stats.RecordEvaluation(gateId, !gate->IsSequential(), changed));
+    if (vcdWriter) {
+        vcdWriter->Sample(gateId);
+    }
+    return changed;
+}
+
+// Returns the index of a named gate, or -1 if it does not exist
+int Circuit::FindGate(const std::string& gateName) const {
+    auto it = gateIds.find(gateName);
+    return (it != gateIds.end()) ? it->second : -1;
+}
+
+// Pushes a changed gate output through its fan-out until the logic settles
+void Circuit::Propagate(int gateId) {
+    std::vector<int> pending{gateId};
+    size_t eventLimit = 64 * (gates.size() + 1);        // Guards against combinational loops
+    size_t events = 0;
+
+    while (!pending.empty()) {
+        int source = pending.back();
+        pending.pop_back();
+        eLogicLevel level = gates[source]->GetOutputState();
+        for (const SConnection& connection : fanouts[source]) {
+            if (ApplyInput(connection.gate, connection.inputIndex, level)) {
+                pending.push_back(connection.gate);     // Only real transitions travel further
+            }
+        }
+        if (++events > eventLimit) {
+            *errors << "Error: Circuit did not settle, check for combinational loops." << std::endl;
+            return;
+        }
+    }
+}
+
+// Orders gates so that every gate comes after the gates driving it; flip-flop
+// outputs start new paths, so register feedback does not form a loop
+void Circuit::Levelize() {
+    CTraceSpan span("Levelize", "compile");
+    std::vector<int> pendingInputs(gates.size(), 0);
+    fanins.resize(gates.size());
+    for (size_t gateId = 0; gateId < gates.size(); ++gateId) {
+        fanins[gateId].assign(gates[gateId]->GetInputCount(), -1);
+    }
+    for (size_t source = 0; source < gates.size(); ++source) {
+        for (const SConnection& connection : fanouts[source]) {
+            fanins[connection.gate][connection.inputIndex] = static_cast<int>(source);
+            if (!gates[connection.gate]->IsSequential()) {
+                ++pendingInputs[connection.gate];
+            }
+        }
+    }
+
+    evalOrder.clear();
+    for (size_t gateId = 0; gateId < gates.size(); ++gateId) {
+        if (pendingInputs[gateId] == 0) {
+            evalOrder.push_back(static_cast<int>(gateId));
+        }
+    }
+    for (size_t next = 0; next < evalOrder.size(); ++next) {
+        for (const SConnection& connection : fanouts[evalOrder[next]]) {
+            if (!gates[connection.gate]->IsSequential() && --pendingInputs[connection.gate] == 0) {
+                evalOrder.push_back(connection.gate);
+            }
+        }
+    }
+
+    if (evalOrder.size() != gates.size()) {
+        *errors << "Error: Combinational loop detected, clocked results may be wrong." << std::endl;
+        for (size_t gateId = 0; gateId < gates.size(); ++gateId) {
+            if (pendingInputs[gateId] > 0) {
+                evalOrder.push_back(static_cast<int>(gateId));
+            }
+        }
+    }
+    levelsDirty = false;
+}
+
+// Evaluates the combinational logic once, driving each gate's fan-out in level order
+void Circuit::EvaluateLevels() {
+    for (int gateId : evalOrder) {
+        if (pruned[gateId]) {
+            continue;                                   // Its fan-out is pruned as well
+        }
+        eLogicLevel level = gates[gateId]->GetOutputState();
+        for (const SConnection& connection : fanouts[gateId]) {
+            ApplyInput(connection.gate, connection.inputIndex, level);
+        }
+    }
+}
+
+// Marks a gate and everything it feeds as stale, stopping at registers and at
+// gates that are already stale
+void Circuit::MarkDirty(int gateId) {
+    if (dirty[gateId]) {
+        return;
+    }
+    std::vector<int> pending{gateId};
+    dirty[gateId] = true;
+    while (!pending.empty()) {
+        int source = pending.back();
+        pending.pop_back();
+        for (const SConnection& connection : fanouts[source]) {
+            if (!dirty[connection.gate] && !gates[connection.gate]->IsSequential()) {
+                dirty[connection.gate] = true;
+                pending.push_back(connection.gate);
+            }
+        }
+    }
+}
+
+// Evaluates the stale part of a gate's fan-in cone, drivers first
+void Circuit::EvaluateCone(int gateId) {
+    if (levelsDirty) {
+        Levelize();
+    }
+
+    // Each entry is a gate and the next input to inspect; a gate is marked
+    // clean when pushed so that loops cannot recurse forever
+    std::vector<std::pair<int, size_t>> stack{{gateId, 0}};
+    dirty[gateId] = false;
+    while (!stack.empty()) {
+        int gate = stack.back().first;
+        size_t& input = stack.back().second;
+        int staleSource = -1;
+        while (input < fanins[gate].size() && staleSource < 0) {
+            int source = fanins[gate][input++];
+            if (source >= 0 && dirty[source]) {
+                staleSource = source;
+            }
+        }
+        if (staleSource >= 0) {
+            dirty[staleSource] = false;
+            stack.push_back({staleSource, 0});
+            continue;
+        }
+
+        for (size_t pin = 0; pin < fanins[gate].size(); ++pin) {
+            if (fanins[gate][pin] >= 0) {
+                gates[gate]->SetInput(static_cast<int>(pin), gates[fanins[gate][pin]]->GetOutputState());
+            }
+        }
+        SIM_STATS(eLogicLevel previous = gates[gate]->GetOutputState());
+        gates[gate]->Evaluate();
+        SIM_STATS(stats.RecordEvaluation(gate, true, gates[gate]->GetOutputState() != previous));
+        if (vcdWriter) {
+            vcdWriter->Sample(gate);
+        }
+        stack.pop_back();
+    }
+}
+
+// Evaluates every stale gate so the whole circuit is up to date
+void Circuit::SettleDirty() {
+    if (!lazyEvaluation) {
+        return;
+    }
+    if (levelsDirty) {
+        Levelize();
+    }
+    for (int gateId : evalOrder) {
+        if (dirty[gateId] && !pruned[gateId]) {
+            EvaluateCone(gateId);                       // Pruned gates stay stale until they rejoin
+        }
+    }
+}
+
+// Adds the transitive fan-in of the pending gates to the cone, through registers
+// as well since their state reaches the outputs on later cycles
+void Circuit::MarkCone(std::vector<int> pending, std::vector<bool>& inCone) {
+    for (int gateId : pending) {
+        inCone[gateId] = true;
+    }
+    while (!pending.empty()) {
+        int gateId = pending.back();
+        pending.pop_back();
+        for (int source : fanins[gateId]) {
+            if (source >= 0 && !inCone[source]) {
+                inCone[source] = true;
+                pending.push_back(source);
+            }
+        }
+    }
+}
+
+// Prunes every gate outside the cone. Gates rejoining the cone were skipped while
+// pruned, so they are re-evaluated in level order from their drivers' outputs.
+void Circuit::ApplyCone(const std::vector<bool>& inCone) {
+    std::vector<bool> rejoined(gates.size(), false);
+    for (size_t gateId = 0; gateId < gates.size(); ++gateId) {
+        rejoined[gateId] = pruned[gateId] && inCone[gateId];
+        pruned[gateId] = !inCone[gateId];
+    }
+    for (int gateId : evalOrder) {
+        if (!rejoined[gateId] || gates[gateId]->IsSequential()) {
+            continue;
+        }
+        if (lazyEvaluation) {
+            MarkDirty(gateId);
+            continue;
+        }
+        for (size_t pin = 0; pin < fanins[gateId].size(); ++pin) {
+            if (fanins[gateId][pin] >= 0) {
+                gates[gateId]->SetInput(static_cast<int>(pin), gates[fanins[gateId][pin]]->GetOutputState());
+            }
+        }
+        SIM_STATS(eLogicLevel previous = gates[gateId]->GetOutputState());
+        gates[gateId]->Evaluate();
+        SIM_STATS(stats.RecordEvaluation(gateId, true, gates[gateId]->GetOutputState() != previous));
+        if (vcdWriter) {
+            vcdWriter->Sample(gateId);
+        }
+    }
 }
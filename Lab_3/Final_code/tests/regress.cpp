@@ -0,0 +1,616 @@
+// Golden-output regression and throughput harness.
+// Usage: regress corpus.txt results.csv [--update]
+//
+// Each corpus line names a case:
+//   file <name> <circuit.txt>                          golden is golden/<name>.out
+//   generate <name> <adder|random|lfsr> <size> <vectors> <seed>
+//                                                      golden is golden/<name>.hash
+// Either form may end with optional modes: "partitioned" also runs the case
+// split over worker processes; "stats" runs it with --stats counters and checks
+// the report, without its phase times, against golden/<name>.stats; "trace"
+// runs it pipelined with a trace-event timeline, which must be valid JSON; "vcd"
+// dumps every gate while it runs and checks the dump against golden/<name>.vcd. The replay mode records a case into a binary command log
+// and times a replay of it; the async mode writes the output to a file through
+// the io_uring writer and reads it back; the server mode loads the netlist of a
+// case into a resident simulation server and runs the rest of it there; the
+// batch mode saves the case under two directories with the same file name and
+// runs both copies as one batch into a shared output directory. Every case runs
+// through each engine mode and must reproduce its golden output exactly.
+// Throughput of every run is appended to the results file; gate evaluations are
+// left empty for the server, batch and partitioned modes, which simulate on
+// circuits the harness cannot count.
+
+#include "CAsyncWriter.h"
+#include "CBatchRunner.h"
+#include "CCommandLog.h"
+#include "CFileReader.h"
+#include "CPartitionedSim.h"
+#include "CSimClient.h"
+#include "CSimServer.h"
+#include "CTrace.h"
+#include "CVcdWriter.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// One regression case with its circuit text and golden file
+struct SCase {
+    std::string name;
+    std::string text;
+    std::string goldenPath;
+    bool hashed = false;    // Large generated outputs are checked by line count and hash
+    std::vector<std::string> optionalModes;  // Modes from OPTIONAL_MODES that this case also runs in
+};
+
+// Measurements of one run of a case
+struct SRunMetrics {
+    size_t commands = 0;
+    double seconds = 0.0;
+    uint64_t evaluations = 0;
+    bool evaluationsCounted = false;  // Modes that simulate outside this circuit, or builds without stats, have no count
+};
+
+static const char* MODES[] = {"reference", "pipeline", "lazy", "replay", "async", "server", "batch", "partitioned", 
+                              "stats", "trace", "vcd"};
+static const std::vector<std::string> OPTIONAL_MODES = {"partitioned", "stats", "trace", "vcd"};  // Only for cases that name them
+static const int PARTITIONS = 3;  // Worker processes in the partitioned mode
+static CSimClient* serverClient = nullptr;  // Connection to the harness's own server for the server mode
+
+// Returns the 64-bit FNV-1a hash of the text
+static uint64_t HashText(const std::string& text) {
+    uint64_t hash = 1469598103934665603ULL;
+    for (unsigned char c : text) {
+        hash = (hash ^ c) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Returns the golden form of an output: the text itself, or its line count and hash
+static std::string GoldenForm(const std::string& output, bool hashed) {
+    if (!hashed) {
+        return output;
+    }
+    std::ostringstream form;
+    size_t lines = 0;
+    for (char c : output) {
+        lines += (c == '\n');
+    }
+    form << "lines " << lines << "\nfnv1a " << std::hex << HashText(output) << "\n";
+    return form.str();
+}
+
+// Counts the lines that hold a command
+static size_t CountCommands(const std::string& text) {
+    std::istringstream lines(text);
+    std::string line, word;
+    size_t count = 0;
+    while (std::getline(lines, line)) {
+        std::istringstream words(line);
+        count += (words >> word) && word[0] != '#';
+    }
+    return count;
+}
+
+// Reads a whole file, returning false if it cannot be opened
+static bool ReadFile(const std::string& path, std::string& text) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    std::ostringstream content;
+    content << file.rdbuf();
+    text = content.str();
+    return true;
+}
+
+// Generates a ripple-carry adder of the given width driven by random operands
+static std::string GenerateAdder(int width, int vectors, std::mt19937_64& random) {
+    std::ostringstream text;
+    for (int bit = 0; bit < width; ++bit) {
+        text << "component XOR p" << bit << "\ncomponent AND g" << bit << "\n" 
+             << "component XOR s" << bit << "\ncomponent AND t" << bit << "\n" 
+             << "component OR c" << bit + 1 << "\n";
+        text << "connect p" << bit << " s" << bit << " 0\nconnect p" << bit << " t" << bit << " 0\n" 
+             << "connect g" << bit << " c" << bit + 1 << " 0\nconnect t" << bit << " c" << bit + 1 << " 1\n";
+        if (bit == 0) {
+            text << "tie s0 1 0\ntie t0 1 0\n";  // No carry in
+        } else {
+            text << "connect c" << bit << " s" << bit << " 1\nconnect c" << bit << " t" << bit << " 1\n";
+        }
+    }
+    for (int vector = 0; vector < vectors; ++vector) {
+        for (int bit = 0; bit < width; ++bit) {
+            int a = static_cast<int>(random() & 1), b = static_cast<int>(random() & 1);
+            text << "input p" << bit << " 0 " << a << "\ninput p" << bit << " 1 " << b << "\n" 
+                 << "input g" << bit << " 0 " << a << "\ninput g" << bit << " 1 " << b << "\n";
+        }
+        for (int bit = 0; bit < width; ++bit) {
+            text << "output s" << bit << "\n";
+        }
+        text << "output c" << width << "\n";
+    }
+    text << "end\n";
+    return text.str();
+}
+
+// Generates a random combinational netlist; unconnected inputs are driven at random
+static std::string GenerateRandom(int gateCount, int vectors, std::mt19937_64& random) {
+    static const char* TYPES[] = {"AND", "OR", "XOR", "NOT"};
+    std::ostringstream text;
+    std::vector<std::pair<int, int>> freeInputs;  // Gate and input index of every primary input
+    for (int gate = 0; gate < gateCount; ++gate) {
+        int type = static_cast<int>(random() % 4);
+        int inputCount = (type == 3) ? 1 : 2;
+        text << "component " << TYPES[type] << " n" << gate << "\n";
+        for (int input = 0; input < inputCount; ++input) {
+            if (gate > 0 && random() % 10 < 7) {
+                int window = std::min(gate, 64);  // Sources come from recent gates, keeping cones local
+                int source = gate - 1 - static_cast<int>(random() % window);
+                text << "connect n" << source << " n" << gate << " " << input << "\n";
+            } else {
+                freeInputs.emplace_back(gate, input);
+            }
+        }
+    }
+    for (int vector = 0; vector < vectors; ++vector) {
+        for (int drive = 0; drive < 8 && !freeInputs.empty(); ++drive) {
+            const std::pair<int, int>& pin = freeInputs[random() % freeInputs.size()];
+            text << "input n" << pin.first << " " << pin.second << " " << (random() & 1) << "\n";
+        }
+        for (int probe = 0; probe < 4; ++probe) {
+            int window = std::min(gateCount, 32);
+            text << "output n" << gateCount - 1 - static_cast<int>(random() % window) << "\n";
+        }
+    }
+    text << "end\n";
+    return text.str();
+}
+
+// Generates a register wired as a linear feedback shift register and clocks it
+static std::string GenerateLfsr(int width, int vectors, std::mt19937_64& random) {
+    std::ostringstream text;
+    text << "component REG r " << width << "\ncomponent XOR feedback\n";
+    for (int bit = 0; bit + 1 < width; ++bit) {
+        text << "connect r[" << bit << "] r[" << bit + 1 << "] 0\n";
+    }
+    text << "connect r[" << width - 1 << "] feedback 0\nconnect r[" << width - 2 << "] feedback 1\n" 
+         << "connect feedback r[0] 0\n";
+    for (int bit = 0; bit < width; ++bit) {
+        text << "input r[" << bit << "] 0 " << (random() & 1) << "\n";  // Random seed state
+    }
+    text << "clock 1\n";
+    for (int vector = 0; vector < vectors; ++vector) {
+        text << "clock " << 1 + random() % 4 << "\n";
+        for (int bit = 0; bit < width && bit < 8; ++bit) {
+            text << "output r[" << bit << "]\n";
+        }
+    }
+    text << "end\n";
+    return text.str();
+}
+
+// Reads the corpus manifest; relative paths are relative to the working directory
+static bool ReadCorpus(const std::string& corpusPath, std::vector<SCase>& cases) {
+    std::ifstream corpus(corpusPath);
+    if (!corpus) {
+        std::cerr << "Error: Cannot open corpus " << corpusPath << std::endl;
+        return false;
+    }
+    std::string goldenDirectory = corpusPath.substr(0, corpusPath.find_last_of('/') + 1) + "golden/";
+    std::string line;
+    while (std::getline(corpus, line)) {
+        std::istringstream fields(line);
+        std::string kind;
+        if (!(fields >> kind) || kind[0] == '#') {
+            continue;
+        }
+        SCase regressionCase;
+        fields >> regressionCase.name;
+        if (kind == "file") {
+            std::string path;
+            fields >> path;
+            if (!ReadFile(path, regressionCase.text)) {
+                std::cerr << "Error: Cannot read circuit file " << path << std::endl;
+                return false;
+            }
+            regressionCase.goldenPath = goldenDirectory + regressionCase.name + ".out";
+        } else if (kind == "generate") {
+            std::string generator;
+            int size = 0, vectors = 0;
+            uint64_t seed = 0;
+            fields >> generator >> size >> vectors >> seed;
+            std::mt19937_64 random(seed);
+            if (generator == "adder") {
+                regressionCase.text = GenerateAdder(size, vectors, random);
+            } else if (generator == "random") {
+                regressionCase.text = GenerateRandom(size, vectors, random);
+            } else if (generator == "lfsr") {
+                regressionCase.text = GenerateLfsr(size, vectors, random);
+            } else {
+                std::cerr << "Error: Unknown generator " << generator << std::endl;
+                return false;
+            }
+            regressionCase.goldenPath = goldenDirectory + regressionCase.name + ".hash";
+            regressionCase.hashed = true;
+        } else {
+            std::cerr << "Error: Unknown corpus entry " << kind << std::endl;
+            return false;
+        }
+        std::string mode;
+        while (fields >> mode) {
+            if (std::find(OPTIONAL_MODES.begin(), OPTIONAL_MODES.end(), mode) == OPTIONAL_MODES.end()) {
+                std::cerr << "Error: Unknown optional mode " << mode << std::endl;
+                return false;
+            }
+            regressionCase.optionalModes.push_back(mode);
+        }
+        cases.push_back(regressionCase);
+    }
+    return true;
+}
+
+// Records a case into a binary command log by simulating it once from text
+static bool RecordLog(const SCase& regressionCase, const std::string& logPath) {
+    std::istringstream input(regressionCase.text);
+    std::ostringstream output;
+    Circuit circuit;
+    CFileReader fileReader(circuit, input, output);
+    CCommandLog commandLog;
+    if (!commandLog.Create(logPath)) {
+        return false;
+    }
+    fileReader.RecordTo(&commandLog);
+    fileReader.ProcessInput();
+    return commandLog.Close();
+}
+
+// Splits a case into its leading netlist commands and the commands that follow them
+static void SplitNetlist(const std::string& text, std::string& netlist, std::string& commands) {
+    std::istringstream lines(text);
+    std::string line, word;
+    bool inNetlist = true;
+    while (std::getline(lines, line)) {
+        std::istringstream words(line);
+        if (inNetlist && (words >> word) && word[0] != '#' && word != "component" && word != "connect" 
+            && word != "tie" && word != "observe") {
+            inNetlist = false;
+        }
+        (inNetlist ? netlist : commands) += line + "\n";
+    }
+}
+
+// Sends a header announcing an oversized body; the server must refuse it and drop the connection
+static bool CheckServerLimits(const std::string& socketPath) {
+    CSimConnection connection(CSimConnection::Connect(socketPath));
+    connection.Write("LOAD huge 99999999999999\n");
+    std::string status, text;
+    if (!connection.Flush() || !connection.ReadLine(status) || status.rfind("ERROR ", 0) != 0) {
+        return false;
+    }
+    std::istringstream fields(status.substr(6));
+    size_t outputBytes = 0, errorBytes = 0;
+    fields >> outputBytes >> errorBytes;
+    return connection.ReadBytes(outputBytes + errorBytes, text) && !connection.ReadLine(text);
+}
+
+// Starts a simulation server on a thread and connects to it; returns false if either fails.
+// An idle connection opened first stays silent for the whole run, so the server must
+// serve the client alongside it.
+static bool StartServer(CSimServer& server, std::thread& serverThread, CSimConnection& idleClient, 
+                        CSimClient& client, const std::string& socketPath) {
+    unlink(socketPath.c_str());
+    serverThread = std::thread([&server, socketPath] { server.Serve(socketPath); });
+    for (int attempt = 0; attempt < 500 && access(socketPath.c_str(), F_OK) != 0; ++attempt) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    if (!CheckServerLimits(socketPath)) {
+        std::cerr << "Error: Server accepted an oversized request" << std::endl;
+        return false;
+    }
+    idleClient.Open(CSimConnection::Connect(socketPath));
+    return idleClient.IsOpen() && client.Connect(socketPath);
+}
+
+// Runs two same-named copies of a case as one batch; returns their output if both
+// got their own output file with identical contents, or an empty string
+static std::string RunBatch(const SCase& regressionCase, const std::string& scratchPath) {
+    std::string directory = scratchPath + ".batch";
+    std::vector<std::string> circuitPaths = {directory + "/a/" + regressionCase.name + ".txt", 
+                                             directory + "/b/" + regressionCase.name + ".txt"};
+    for (const char* subdirectory : {"", "/a", "/b", "/out"}) {
+        mkdir((directory + subdirectory).c_str(), 0755);
+    }
+    for (const std::string& path : circuitPaths) {
+        std::ofstream(path, std::ios::binary) << regressionCase.text;
+    }
+    CBatchRunner batchRunner(circuitPaths);
+    std::string first, second;
+    if (batchRunner.Run(1, directory + "/out") != 0  // One job: both copies save checkpoints to the same path
+        || !ReadFile(directory + "/out/1_" + regressionCase.name + ".out", first) 
+        || !ReadFile(directory + "/out/2_" + regressionCase.name + ".out", second) || first != second) {
+        return "";
+    }
+    return first;
+}
+
+// Returns true if a case runs in a mode; optional modes only run for the cases that name them
+static bool RunsIn(const SCase& regressionCase, const std::string& mode) {
+#ifndef ENABLE_STATS
+    if (mode == "stats") {
+        return false;  // The counters are not compiled in
+    }
+#endif
+    const std::vector<std::string>& named = regressionCase.optionalModes;
+    return std::find(OPTIONAL_MODES.begin(), OPTIONAL_MODES.end(), mode) == OPTIONAL_MODES.end() 
+        || std::find(named.begin(), named.end(), mode) != named.end();
+}
+
+// Returns the golden file of a mode: the stats and vcd modes have their own, the others share the case's
+static std::string GoldenPath(const SCase& regressionCase, const std::string& mode) {
+    if (mode == "stats" || mode == "vcd") {
+        return regressionCase.goldenPath.substr(0, regressionCase.goldenPath.find_last_of('.')) + "." + mode;
+    }
+    return regressionCase.goldenPath;
+}
+
+// Removes the phase times, the only part of a statistics report that varies between runs
+static std::string WithoutPhaseTimes(const std::string& report) {
+    std::istringstream lines(report);
+    std::string line, kept;
+    while (std::getline(lines, line)) {
+        if (line.find("\"phases_ms\"") == std::string::npos) {
+            kept += line + "\n";
+        }
+    }
+    return kept;
+}
+
+// Skips JSON whitespace
+static void SkipSpace(const std::string& json, size_t& position) {
+    while (position < json.size() && std::isspace(static_cast<unsigned char>(json[position]))) {
+        ++position;
+    }
+}
+
+// Parses one JSON value starting at position; returns false if it is malformed
+static bool ParseJsonValue(const std::string& json, size_t& position, int depth = 0) {
+    SkipSpace(json, position);
+    if (position >= json.size() || depth > 64) {
+        return false;
+    }
+    char c = json[position];
+    if (c == '{' || c == '[') {
+        char close = (c == '{') ? '}' : ']';
+        SkipSpace(json, ++position);
+        if (position < json.size() && json[position] == close) {
+            ++position;
+            return true;
+        }
+        while (true) {
+            if (c == '{') {
+                SkipSpace(json, position);
+                if (position >= json.size() || json[position] != '"' || !ParseJsonValue(json, position, depth + 1)) {
+                    return false;  // Object keys are strings
+                }
+                SkipSpace(json, position);
+                if (position >= json.size() || json[position++] != ':') {
+                    return false;
+                }
+            }
+            if (!ParseJsonValue(json, position, depth + 1)) {
+                return false;
+            }
+            SkipSpace(json, position);
+            if (position >= json.size()) {
+                return false;
+            }
+            char next = json[position++];
+            if (next == close) {
+                return true;
+            }
+            if (next != ',') {
+                return false;
+            }
+        }
+    }
+    if (c == '"') {
+        for (++position; position < json.size() && json[position] != '"'; ++position) {
+            if (static_cast<unsigned char>(json[position]) < 0x20) {
+                return false;
+            }
+            if (json[position] == '\\' 
+                && (++position >= json.size() || std::strchr("\"\\/bfnrtu", json[position]) == nullptr)) {
+                return false;  // Unknown escape
+            }
+        }
+        return position++ < json.size();
+    }
+    for (const char* literal : {"true", "false", "null"}) {
+        if (json.compare(position, std::strlen(literal), literal) == 0) {
+            position += std::strlen(literal);
+            return true;
+        }
+    }
+    const char* start = json.c_str() + position;
+    char* end = nullptr;
+    std::strtod(start, &end);
+    position += static_cast<size_t>(end - start);
+    return end != start && (c == '-' || std::isdigit(static_cast<unsigned char>(c)));
+}
+
+// Returns true if the text is one JSON object holding a traceEvents array
+static bool IsTraceJson(const std::string& json) {
+    size_t position = 0;
+    if (!ParseJsonValue(json, position)) {
+        return false;
+    }
+    SkipSpace(json, position);
+    return position == json.size() && json[0] == '{' && json.find("\"traceEvents\": [") != std::string::npos;
+}
+
+// Simulates a case in one engine mode and returns everything it printed; scratchPath
+// names the command log and the output file the modes write
+static std::string RunCase(const SCase& regressionCase, const std::string& mode, const std::string& scratchPath, 
+                           SRunMetrics& metrics) {
+    std::istringstream input((mode == "lazy") ? "lazy on\n" + regressionCase.text : regressionCase.text);
+    std::ostringstream output;
+    int outputFd = (mode == "async") ? open((scratchPath + ".out").c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644) : -1;
+    CAsyncWriter* asyncWriter = (outputFd >= 0) ? new CAsyncWriter(outputFd) : nullptr;
+    std::ostream asyncOutput(asyncWriter);
+    Circuit circuit;
+    CFileReader fileReader(circuit, input, asyncWriter ? asyncOutput : output);
+    CCommandLog commandLog;
+    if (mode == "stats") {
+        circuit.GetStats().Enable();
+    } else if (mode == "trace") {
+        CTrace::Instance().Start(scratchPath + ".trace.json");
+    }
+    CVcdWriter* vcdWriter = (mode == "vcd") ? new CVcdWriter(scratchPath + ".vcd", {}) : nullptr;
+    circuit.SetVcdWriter(vcdWriter);
+    if (mode == "replay") {
+        if (!RecordLog(regressionCase, scratchPath + ".log") || !commandLog.Load(scratchPath + ".log")) {
+            return "";
+        }
+        fileReader.ReplayFrom(&commandLog);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    if (mode == "partitioned") {
+        CPartitionedSim partitionedSim(PARTITIONS);
+        partitionedSim.Run(input, output);
+    } else if (mode == "server") {
+        std::string netlist, commands;
+        SSimReply loaded, ran;
+        SplitNetlist(regressionCase.text, netlist, commands);
+        if (serverClient->Load(regressionCase.name, netlist, loaded) 
+            && serverClient->Run(regressionCase.name, commands, ran)) {
+            output << loaded.output << ran.output;  // The netlist is built once, the rest runs on a copy
+        }
+    } else if (mode == "batch") {
+        output << RunBatch(regressionCase, scratchPath);
+    } else if (mode == "pipeline" || mode == "trace") {
+        fileReader.ProcessInputPipelined();
+    } else {
+        fileReader.ProcessInput();  // Reference, lazy, replay, stats and vcd
+    }
+    if (asyncWriter) {
+        asyncWriter->Close();  // The write in flight is part of the run
+    }
+    metrics.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    metrics.commands = CountCommands(regressionCase.text);
+#ifdef ENABLE_STATS
+    metrics.evaluationsCounted = (mode != "server" && mode != "batch" && mode != "partitioned");
+#endif
+    metrics.evaluations = metrics.evaluationsCounted ? circuit.GetStats().GetTotals().evaluations : 0;
+    if (asyncWriter) {
+        delete asyncWriter;
+        close(outputFd);
+        std::string written;
+        ReadFile(scratchPath + ".out", written);
+        return written;
+    }
+    if (vcdWriter) {
+        circuit.SetVcdWriter(nullptr);
+        delete vcdWriter;  // Flushes and closes the dump
+        std::string dump;
+        ReadFile(scratchPath + ".vcd", dump);
+        return dump;
+    }
+    if (mode == "trace") {
+        CTrace::Instance().Write();
+        std::string trace;
+        return (ReadFile(scratchPath + ".trace.json", trace) && IsTraceJson(trace)) ? output.str() : "";
+    }
+    if (mode == "stats") {
+        std::ostringstream report;
+        circuit.WriteStats(report);
+        return WithoutPhaseTimes(report.str());
+    }
+    return output.str();
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " corpus.txt results.csv [--update]" << std::endl;
+        return 2;
+    }
+    bool update = (argc > 3 && std::string(argv[3]) == "--update");  // Rewrite goldens from the reference mode
+    std::vector<SCase> cases;
+    if (!ReadCorpus(argv[1], cases)) {
+        return 2;
+    }
+    CSimServer server;
+    CSimConnection idleClient;
+    CSimClient client;
+    std::thread serverThread;
+    bool serving = StartServer(server, serverThread, idleClient, client, std::string(argv[2]) + ".sock");
+    serverClient = serving ? &client : nullptr;
+
+    std::ofstream results(argv[2]);
+    results << "case,mode,commands,seconds,commands_per_s,gate_evals,gate_evals_per_s,status\n";
+
+    int failures = 0;
+    for (const SCase& regressionCase : cases) {
+        for (const char* mode : MODES) {
+            if (!RunsIn(regressionCase, mode) || (std::string(mode) == "server" && !serving)) {
+                continue;
+            }
+            std::string goldenPath = GoldenPath(regressionCase, mode);
+            std::string golden;
+            bool haveGolden = ReadFile(goldenPath, golden);
+            SRunMetrics metrics;
+            std::string output = RunCase(regressionCase, mode, argv[2], metrics);
+            std::string form = GoldenForm(output, regressionCase.hashed);
+            if (update && (std::string(mode) == "reference" || goldenPath != regressionCase.goldenPath)) {
+                std::ofstream(goldenPath, std::ios::binary) << form;
+                golden = form;
+                haveGolden = true;
+            }
+
+            const char* status = !haveGolden ? "missing" : (form == golden) ? "pass" : "FAIL";
+            if (form != golden) {
+                ++failures;
+                std::ofstream(std::string(argv[2]) + "." + regressionCase.name + "." + mode + ".actual", 
+                              std::ios::binary) << output;  // Kept for diffing
+            }
+            double seconds = std::max(metrics.seconds, 1e-9);
+            std::string evaluations = "-";  // Left empty in the results when there is no count
+            std::string evaluationRate = "-";
+            if (metrics.evaluationsCounted) {
+                evaluations = std::to_string(metrics.evaluations);
+                evaluationRate = std::to_string(static_cast<uint64_t>(metrics.evaluations / seconds));
+            }
+            results << regressionCase.name << "," << mode << "," << metrics.commands << "," 
+                    << metrics.seconds << "," << metrics.commands / seconds << "," 
+                    << (metrics.evaluationsCounted ? evaluations + "," + evaluationRate : ",") << "," << status << "\n";
+            std::cout << std::left << std::setw(20) << regressionCase.name << std::setw(12) << mode 
+                      << std::setw(8) << status << std::right << std::setw(12) 
+                      << static_cast<uint64_t>(metrics.commands / seconds) << " commands/s" 
+                      << std::setw(14) << evaluationRate << " evals/s\n";
+        }
+    }
+    if (!serving) {
+        client.Connect(std::string(argv[2]) + ".sock");  // Reaches a server that failed the limits check
+    }
+    client.Shutdown();
+    if (serverThread.joinable()) {
+        serverThread.join();
+    }
+    failures += serving ? 0 : 1;
+    std::cout << failures << " failed" << std::endl;
+    return (failures == 0) ? 0 : 1;
+}
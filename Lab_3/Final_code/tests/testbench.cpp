@@ -0,0 +1,144 @@
+// Checks of the coroutine testbench: stimulus and monitors on a half adder,
+// register waves awaited with Until, and many processes stepping the clock.
+// Usage: testbench
+
+#include "CTestbench.h"
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+static const eLogicLevel LOW = eLogicLevel::LOGIC_LOW;
+static const eLogicLevel HIGH = eLogicLevel::LOGIC_HIGH;
+
+static int failures = 0;
+
+// Reports a failed check
+static void Check(bool passed, const std::string& what) {
+    if (!passed) {
+        std::cerr << "Error: " << what << std::endl;
+        ++failures;
+    }
+}
+
+// Drives every operand pair into the half adder, one per cycle
+static CTestbenchProcess DriveOperands(CTestbench& sim, STestbenchNet sum, STestbenchNet carry) {
+    for (int operands = 0; operands < 4; ++operands) {
+        eLogicLevel a = (operands & 1) ? HIGH : LOW, b = (operands & 2) ? HIGH : LOW;
+        sim.Drive(sum, 0, a);
+        sim.Drive(sum, 1, b);
+        sim.Drive(carry, 0, a);
+        sim.Drive(carry, 1, b);
+        Check(sim.Read(sum) == (((operands & 1) != (operands >> 1)) ? HIGH : LOW), "half adder sum " + std::to_string(operands));
+        Check(sim.Read(carry) == ((operands == 3) ? HIGH : LOW), "half adder carry " + std::to_string(operands));
+        co_await sim.Step();
+    }
+}
+
+// Waits for the carry, which only rises in the cycle both operands are high
+static CTestbenchProcess WatchCarry(CTestbench& sim, STestbenchNet carry, uint64_t& riseCycle) {
+    co_await sim.Until(carry == HIGH);
+    riseCycle = sim.GetCycle();
+}
+
+// Sends a single high bit into the first register of the chain
+static CTestbenchProcess SendPulse(CTestbench& sim, STestbenchNet first) {
+    sim.Drive(first, 0, HIGH);
+    co_await sim.Step();
+    sim.Drive(first, 0, LOW);
+}
+
+// Records the cycle a register bit goes high and then low again
+static CTestbenchProcess WatchBit(CTestbench& sim, STestbenchNet bit, uint64_t& riseCycle, uint64_t& fallCycle) {
+    co_await sim.Until(bit == HIGH);
+    riseCycle = sim.GetCycle();
+    co_await sim.Until(bit == LOW);
+    fallCycle = sim.GetCycle();
+}
+
+// Steps the clock a number of times and counts the steps
+static CTestbenchProcess Ticker(CTestbench& sim, int steps, int stride, uint64_t& total) {
+    for (int step = 0; step < steps; ++step) {
+        co_await sim.Step(stride);
+        ++total;
+    }
+}
+
+// Throws once resumed, to check that failures reach Run
+static CTestbenchProcess Fail(CTestbench& sim) {
+    co_await sim.Step();
+    throw std::runtime_error("expected failure");
+}
+
+int main() {
+    {
+        Circuit circuit;
+        circuit.AddGate("XOR", "sum");
+        circuit.AddGate("AND", "carry");
+        CTestbench sim(circuit);
+        uint64_t riseCycle = 0;
+        sim.Spawn(WatchCarry(sim, sim.Net("carry"), riseCycle));
+        sim.Spawn(DriveOperands(sim, sim.Net("sum"), sim.Net("carry")));
+        Check(sim.Run(100) == 4, "half adder runs 4 cycles");
+        Check(riseCycle == 3, "carry rises in cycle 3, not " + std::to_string(riseCycle));
+        Check(sim.GetProcessCount() == 0, "half adder processes finish");
+    }
+
+    {
+        const int width = 16;
+        Circuit circuit;
+        circuit.AddRegister("r", width);
+        for (int bit = 0; bit + 1 < width; ++bit) {
+            circuit.ConnectGates("r[" + std::to_string(bit) + "]", "r[" + std::to_string(bit + 1) + "]", 0);
+        }
+        CTestbench sim(circuit);
+        std::vector<uint64_t> rise(width, 0), fall(width, 0);
+        for (int bit = 0; bit < width; ++bit) {
+            sim.Spawn(WatchBit(sim, sim.Net("r[" + std::to_string(bit) + "]"), rise[bit], fall[bit]));
+        }
+        sim.Spawn(SendPulse(sim, sim.Net("r[0]")));
+        uint64_t total = 0;
+        sim.Spawn(Ticker(sim, width + 1, 1, total));
+        sim.Run(1000);
+        for (int bit = 0; bit < width; ++bit) {
+            Check(rise[bit] == static_cast<uint64_t>(bit + 1) && fall[bit] == static_cast<uint64_t>(bit + 2), 
+                  "pulse through r[" + std::to_string(bit) + "] at cycles " + std::to_string(rise[bit]) + ", " 
+                  + std::to_string(fall[bit]));
+        }
+    }
+
+    {
+        const int processes = 10000, steps = 100;
+        Circuit circuit;
+        circuit.AddRegister("r", 1);
+        CTestbench sim(circuit);
+        uint64_t total = 0;
+        for (int process = 0; process < processes; ++process) {
+            sim.Spawn(Ticker(sim, steps, 1 + process % 3, total));
+        }
+        auto start = std::chrono::steady_clock::now();
+        uint64_t cycles = sim.Run(1000000);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        Check(total == static_cast<uint64_t>(processes) * steps, "every process steps " + std::to_string(steps) + " times");
+        Check(cycles == 3 * steps, "stepping runs " + std::to_string(3 * steps) + " cycles, not " + std::to_string(cycles));
+        std::cout << processes << " processes, " << total << " steps in " << seconds * 1000.0 << " ms" << std::endl;
+    }
+
+    {
+        Circuit circuit;
+        circuit.AddRegister("r", 1);
+        CTestbench sim(circuit);
+        sim.Spawn(Fail(sim));
+        bool thrown = false;
+        try {
+            sim.Run(10);
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        Check(thrown, "a process exception reaches Run");
+    }
+
+    std::cout << failures << " failed" << std::endl;
+    return (failures == 0) ? 0 : 1;
+}